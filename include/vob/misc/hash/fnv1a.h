@@ -1,16 +1,30 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
 
 namespace vob::mishs
 {
-	constexpr std::uint64_t fnv1a(std::string_view a_str)
+	/// @brief Hashes a string, characters being combined from last to first.
+	/// Iterative so it can be evaluated at compile time on strings longer than the constexpr recursion limit.
+	constexpr std::uint64_t fnv1a(std::string_view const a_str)
 	{
-		return a_str.empty()
-			? 0xcbf29ce484222325
-			: ((fnv1a(a_str.substr(1)) ^ static_cast<std::uint64_t>(a_str.front()))
-				* 0x100000001b3);
+		std::uint64_t hash = 0xcbf29ce484222325;
+		for (auto it = a_str.rbegin(); it != a_str.rend(); ++it)
+		{
+			hash = (hash ^ static_cast<std::uint64_t>(*it)) * 0x100000001b3;
+		}
+		return hash;
 	}
-}
\ No newline at end of file
+
+	/// @brief Hash functor using fnv1a, so hash tables can be looked up with hashes computed at compile time.
+	struct fnv1a_hash
+	{
+		constexpr std::size_t operator()(std::string_view const a_str) const
+		{
+			return static_cast<std::size_t>(fnv1a(a_str));
+		}
+	};
+}
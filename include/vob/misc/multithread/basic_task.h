@@ -1,16 +1,29 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <span>
 #include <vector>
 
 
 namespace vob::mismt
 {
+	using task_id = std::size_t;
+
 	class basic_task
 	{
 	public:
 		virtual void execute() const = 0;
+
+		/// @brief Provides a version of the inputs of the task, that must change whenever they do.
+		/// An incremental execution skips the task when its version did not change since it last executed and none
+		/// of its dependencies executed. Tasks without a version always execute.
+		[[nodiscard]] virtual std::optional<std::uint64_t> get_input_version() const
+		{
+			return std::nullopt;
+		}
 	};
 
 	using task_span = std::span<std::shared_ptr<basic_task>>;
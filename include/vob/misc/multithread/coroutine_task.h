@@ -0,0 +1,264 @@
+#pragma once
+
+#include "basic_task.h"
+
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <utility>
+
+
+namespace vob::mismt
+{
+	class task_context;
+
+	namespace detail
+	{
+		/// @brief A node of the intrusive list of coroutines waiting for a task to be done.
+		struct task_waiter
+		{
+			task_waiter* m_next = nullptr;
+			std::size_t m_id = 0;
+		};
+
+		/// @brief What a worker able to suspend coroutine tasks provides to them.
+		class coroutine_scheduler
+		{
+		public:
+			// Methods
+			/// @brief Suspends a task until another one is done, returning false if it already is.
+			virtual bool suspend_until_done(
+				std::size_t a_id,
+				std::size_t a_awaitedId,
+				std::coroutine_handle<> a_handle,
+				task_waiter& a_waiter) = 0;
+
+			/// @brief Suspends a task so that other ready tasks of its thread execute before it resumes.
+			virtual bool suspend_and_yield(std::size_t a_id, std::coroutine_handle<> a_handle) = 0;
+
+			/// @brief Notifies that a coroutine task reached its end and its frame was destroyed.
+			virtual void complete(std::size_t a_id) = 0;
+
+		protected:
+			~coroutine_scheduler() = default;
+		};
+	}
+
+	/// @brief The coroutine a coroutine task executes. It does not start until its worker resumes it.
+	class coroutine
+	{
+	public:
+		// Types
+		class promise_type
+		{
+		public:
+			// Methods
+			coroutine get_return_object()
+			{
+				return coroutine{ std::coroutine_handle<promise_type>::from_promise(*this) };
+			}
+
+			std::suspend_always initial_suspend() noexcept
+			{
+				return {};
+			}
+
+			auto final_suspend() noexcept
+			{
+				struct final_awaiter
+				{
+					bool await_ready() noexcept
+					{
+						return false;
+					}
+
+					void await_suspend(std::coroutine_handle<promise_type> a_handle) noexcept
+					{
+						// Without a scheduler, the coroutine object still owns the frame and destroys it
+						auto const scheduler = a_handle.promise().m_scheduler;
+						if (scheduler != nullptr)
+						{
+							auto const id = a_handle.promise().m_id;
+							a_handle.destroy();
+							scheduler->complete(id);
+						}
+					}
+
+					void await_resume() noexcept
+					{}
+				};
+				return final_awaiter{};
+			}
+
+			void return_void()
+			{}
+
+			void unhandled_exception()
+			{
+				std::terminate();
+			}
+
+			void set_scheduler(detail::coroutine_scheduler* a_scheduler, std::size_t const a_id)
+			{
+				m_scheduler = a_scheduler;
+				m_id = a_id;
+			}
+
+		private:
+			// Attributes
+			detail::coroutine_scheduler* m_scheduler = nullptr;
+			std::size_t m_id = 0;
+		};
+
+		// Constructors
+		coroutine(coroutine&& a_other) noexcept
+			: m_handle{ std::exchange(a_other.m_handle, nullptr) }
+		{}
+
+		coroutine(coroutine const&) = delete;
+
+		~coroutine()
+		{
+			if (m_handle)
+			{
+				m_handle.destroy();
+			}
+		}
+
+		// Methods
+		/// @brief Resumes the coroutine, returning whether it reached its end. The frame stays owned either way.
+		bool resume()
+		{
+			m_handle.resume();
+			return m_handle.done();
+		}
+
+		/// @brief Gives up the ownership of the coroutine frame, which destroys itself once it reaches its end as
+		/// long as a scheduler is set on its promise.
+		std::coroutine_handle<promise_type> release()
+		{
+			return std::exchange(m_handle, nullptr);
+		}
+
+		// Operators
+		coroutine& operator=(coroutine&& a_other) noexcept
+		{
+			if (this != &a_other)
+			{
+				if (m_handle)
+				{
+					m_handle.destroy();
+				}
+				m_handle = std::exchange(a_other.m_handle, nullptr);
+			}
+			return *this;
+		}
+
+		coroutine& operator=(coroutine const&) = delete;
+
+	private:
+		// Constructors
+		explicit coroutine(std::coroutine_handle<promise_type> a_handle)
+			: m_handle{ a_handle }
+		{}
+
+		// Attributes
+		std::coroutine_handle<promise_type> m_handle;
+	};
+
+	/// @brief What a coroutine task can co_await on: another task being done, or a point where it lets other tasks
+	/// execute on its thread.
+	/// With a work-stealing worker, any scheduled task can be awaited, as long as no cycle goes through awaits and
+	/// dependencies: a task must not await a task that depends on it or awaits it, directly or not, or the execution
+	/// never ends. Other workers execute coroutine tasks in one go and cannot wait, so with them awaited tasks must be
+	/// dependencies of the awaiting task.
+	class task_context
+	{
+	public:
+		// Constructors
+		task_context(detail::coroutine_scheduler* a_scheduler, std::size_t const a_id)
+			: m_scheduler{ a_scheduler }
+			, m_id{ a_id }
+		{}
+
+		// Methods
+		[[nodiscard]] std::size_t get_id() const
+		{
+			return m_id;
+		}
+
+		/// @brief Suspends the coroutine until a task is done.
+		[[nodiscard]] auto wait_for(std::size_t const a_awaitedId) const
+		{
+			struct awaiter
+			{
+				bool await_ready() const noexcept
+				{
+					return m_scheduler == nullptr;
+				}
+
+				bool await_suspend(std::coroutine_handle<> a_handle)
+				{
+					return m_scheduler->suspend_until_done(m_id, m_awaitedId, a_handle, m_waiter);
+				}
+
+				void await_resume() const noexcept
+				{}
+
+				detail::coroutine_scheduler* m_scheduler;
+				std::size_t m_id;
+				std::size_t m_awaitedId;
+				detail::task_waiter m_waiter;
+			};
+			return awaiter{ m_scheduler, m_id, a_awaitedId, {} };
+		}
+
+		/// @brief Suspends the coroutine until other ready tasks of its thread executed.
+		[[nodiscard]] auto yield() const
+		{
+			struct awaiter
+			{
+				bool await_ready() const noexcept
+				{
+					return m_scheduler == nullptr;
+				}
+
+				bool await_suspend(std::coroutine_handle<> a_handle)
+				{
+					return m_scheduler->suspend_and_yield(m_id, a_handle);
+				}
+
+				void await_resume() const noexcept
+				{}
+
+				detail::coroutine_scheduler* m_scheduler;
+				std::size_t m_id;
+			};
+			return awaiter{ m_scheduler, m_id };
+		}
+
+	private:
+		// Attributes
+		detail::coroutine_scheduler* m_scheduler;
+		std::size_t m_id;
+	};
+
+	/// @brief A task whose execution is a coroutine, so it can wait for other tasks or yield without holding its
+	/// thread when executed by a work-stealing worker.
+	/// Other workers execute it in one go: they only start a task once its dependencies are done, so waiting for them
+	/// never suspends, and yielding does nothing. They cannot wait for a task that is not a dependency.
+	class basic_coroutine_task : public basic_task
+	{
+	public:
+		// Methods
+		virtual coroutine execute_async(task_context a_context) const = 0;
+
+		void execute() const override
+		{
+			// Suspending on anything but the task context would leave the coroutine unfinished
+			[[maybe_unused]] auto const isDone = execute_async(task_context{ nullptr, 0 }).resume();
+			assert(isDone);
+		}
+	};
+}
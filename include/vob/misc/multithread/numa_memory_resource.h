@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace vob::mismt
+{
+	/// @brief A memory resource whose memory is physically placed on a NUMA node, so that a worker whose threads
+	/// run on that node keeps its task states, schedules and traces local.
+	/// Every allocation maps whole pages: it is meant as the upstream resource of a pool or monotonic resource.
+	/// On platforms without NUMA support, allocations come from the new/delete resource. On Linux, binding is a
+	/// preference: if the kernel cannot bind pages to the node, e.g. without NUMA support, the default policy places
+	/// them, and if the node is full, other nodes are used.
+	class numa_memory_resource final : public std::pmr::memory_resource
+	{
+	public:
+		// Constructors
+		explicit numa_memory_resource(std::size_t const a_numaNode)
+			: m_numaNode{ a_numaNode }
+		{
+#if defined(__linux__)
+			assert(a_numaNode < s_maxNumaNodeCount);
+#endif
+		}
+
+		// Methods
+		[[nodiscard]] std::size_t get_numa_node() const
+		{
+			return m_numaNode;
+		}
+
+	private:
+		// Constants
+#if defined(__linux__)
+		/// @brief Prefers the node but falls back to others rather than failing when it is full.
+		static constexpr int s_preferredPolicy = 1;
+		/// @brief The largest number of nodes a Linux kernel supports.
+		static constexpr std::size_t s_maxNumaNodeCount = 1024;
+#endif
+
+		// Attributes
+		std::size_t m_numaNode;
+
+		// Methods
+		void* do_allocate(std::size_t const a_bytes, [[maybe_unused]] std::size_t const a_alignment) override
+		{
+#if defined(_WIN32)
+			assert(a_alignment <= 4096);
+			auto const memory = VirtualAllocExNuma(
+				GetCurrentProcess(),
+				nullptr,
+				a_bytes,
+				MEM_RESERVE | MEM_COMMIT,
+				PAGE_READWRITE,
+				static_cast<DWORD>(m_numaNode));
+			if (memory == nullptr)
+			{
+				throw std::bad_alloc{};
+			}
+			return memory;
+#elif defined(__linux__)
+			assert(a_alignment <= static_cast<std::size_t>(sysconf(_SC_PAGESIZE)));
+			auto const memory = mmap(nullptr, a_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (memory == MAP_FAILED)
+			{
+				throw std::bad_alloc{};
+			}
+
+			// Pages are only backed on first touch, so binding them now decides where they end up. Failing to bind
+			// leaves them to the default policy, which is still valid memory
+			constexpr auto bitsPerMask = sizeof(unsigned long) * 8;
+			unsigned long nodeMask[s_maxNumaNodeCount / bitsPerMask]{};
+			if (m_numaNode < s_maxNumaNodeCount)
+			{
+				nodeMask[m_numaNode / bitsPerMask] = 1ul << (m_numaNode % bitsPerMask);
+				static_cast<void>(syscall(
+					SYS_mbind, memory, a_bytes, s_preferredPolicy, nodeMask, s_maxNumaNodeCount + 1, 0));
+			}
+			return memory;
+#else
+			return std::pmr::new_delete_resource()->allocate(a_bytes, a_alignment);
+#endif
+		}
+
+		void do_deallocate(
+			void* const a_pointer,
+			[[maybe_unused]] std::size_t const a_bytes,
+			[[maybe_unused]] std::size_t const a_alignment) override
+		{
+#if defined(_WIN32)
+			VirtualFree(a_pointer, 0, MEM_RELEASE);
+#elif defined(__linux__)
+			munmap(a_pointer, a_bytes);
+#else
+			std::pmr::new_delete_resource()->deallocate(a_pointer, a_bytes, a_alignment);
+#endif
+		}
+
+		bool do_is_equal(std::pmr::memory_resource const& a_other) const noexcept override
+		{
+			auto const other = dynamic_cast<numa_memory_resource const*>(&a_other);
+			return other != nullptr && other->m_numaNode == m_numaNode;
+		}
+	};
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "basic_task.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <optional>
+#include <ranges>
+#include <vector>
+
+
+namespace vob::mismt
+{
+	namespace detail
+	{
+		/// @brief Splits [begin; end) into chunks of a grain size, that threads grab one after another until none is
+		/// left, so faster threads end up processing more chunks.
+		class chunked_range
+		{
+		public:
+			// Constructors
+			chunked_range(
+				std::size_t const a_begin,
+				std::size_t const a_end,
+				std::size_t const a_grainSize,
+				std::size_t const a_threadCount)
+				: m_begin{ a_begin }
+				, m_end{ std::max(a_begin, a_end) }
+				, m_grainSize{ a_grainSize != 0
+					? a_grainSize
+					: std::max<std::size_t>(1, (m_end - m_begin) / (a_threadCount * s_chunksPerThread)) }
+			{}
+
+			// Methods
+			[[nodiscard]] std::size_t get_chunk_count() const
+			{
+				return (m_end - m_begin + m_grainSize - 1) / m_grainSize;
+			}
+
+			/// @brief Grabs the next chunk to process, returning false when all were grabbed.
+			bool grab(std::size_t& a_chunk, std::size_t& a_begin, std::size_t& a_end) const
+			{
+				a_chunk = m_nextChunk.fetch_add(1, std::memory_order_relaxed);
+				if (a_chunk >= get_chunk_count())
+				{
+					return false;
+				}
+				a_begin = m_begin + a_chunk * m_grainSize;
+				a_end = std::min(a_begin + m_grainSize, m_end);
+				return true;
+			}
+
+		private:
+			// Constants
+			static constexpr std::size_t s_chunksPerThread = 8;
+
+			// Attributes
+			std::size_t m_begin;
+			std::size_t m_end;
+			std::size_t m_grainSize;
+			mutable std::atomic<std::size_t> m_nextChunk = 0;
+		};
+
+		template <typename TFunction>
+		class parallel_for_task final : public basic_task
+		{
+		public:
+			// Constructors
+			parallel_for_task(chunked_range const& a_range, TFunction& a_function)
+				: m_range{ a_range }
+				, m_function{ a_function }
+			{}
+
+			// Methods
+			void execute() const override
+			{
+				std::size_t chunk, begin, end;
+				while (m_range.grab(chunk, begin, end))
+				{
+					for (auto index = begin; index < end; ++index)
+					{
+						m_function(index);
+					}
+				}
+			}
+
+		private:
+			// Attributes
+			chunked_range const& m_range;
+			TFunction& m_function;
+		};
+
+		template <typename TValue, typename TFunction>
+		class parallel_reduce_task final : public basic_task
+		{
+		public:
+			// Constructors
+			parallel_reduce_task(
+				chunked_range const& a_range,
+				TValue const& a_identity,
+				TFunction& a_function,
+				std::vector<std::optional<TValue>>& a_chunkResults)
+				: m_range{ a_range }
+				, m_identity{ a_identity }
+				, m_function{ a_function }
+				, m_chunkResults{ a_chunkResults }
+			{}
+
+			// Methods
+			void execute() const override
+			{
+				std::size_t chunk, begin, end;
+				while (m_range.grab(chunk, begin, end))
+				{
+					auto result = m_identity;
+					for (auto index = begin; index < end; ++index)
+					{
+						result = m_function(std::move(result), index);
+					}
+					m_chunkResults[chunk].emplace(std::move(result));
+				}
+			}
+
+		private:
+			// Attributes
+			chunked_range const& m_range;
+			TValue const& m_identity;
+			TFunction& m_function;
+			std::vector<std::optional<TValue>>& m_chunkResults;
+		};
+	}
+
+	/// @brief Calls a function for each index of [begin; end) on all threads of a worker, including the calling one.
+	/// Indices are processed in chunks of a grain size: 0 picks one giving each thread several chunks to balance.
+	/// Must not be called during an execution of the worker.
+	template <typename TWorker, typename TFunction>
+	void parallel_for(
+		TWorker& a_worker,
+		std::size_t const a_begin,
+		std::size_t const a_end,
+		TFunction a_function,
+		std::size_t const a_grainSize = 0)
+	{
+		detail::chunked_range const range{ a_begin, a_end, a_grainSize, a_worker.get_thread_count() };
+		if (range.get_chunk_count() == 0)
+		{
+			return;
+		}
+		a_worker.execute_on_all_threads(detail::parallel_for_task<TFunction>{ range, a_function });
+	}
+
+	/// @brief Calls a function for each element of a random access range on all threads of a worker, including the
+	/// calling one. See the index-based overload.
+	template <typename TWorker, std::ranges::random_access_range TRange, typename TFunction>
+	void parallel_for(TWorker& a_worker, TRange&& a_range, TFunction a_function, std::size_t const a_grainSize = 0)
+	{
+		auto const begin = std::ranges::begin(a_range);
+		parallel_for(
+			a_worker,
+			0,
+			static_cast<std::size_t>(std::ranges::distance(a_range)),
+			[&begin, &a_function](std::size_t const a_index)
+			{
+				a_function(begin[a_index]);
+			},
+			a_grainSize);
+	}
+
+	/// @brief Folds each index of [begin; end) into a value on all threads of a worker, including the calling one.
+	/// Each chunk is folded from the identity with function(value, index), then chunk results are combined in order
+	/// with reduce(value, value) so the result does not depend on how chunks were spread over threads.
+	/// Must not be called during an execution of the worker.
+	template <typename TWorker, typename TValue, typename TFunction, typename TReduce>
+	TValue parallel_reduce(
+		TWorker& a_worker,
+		std::size_t const a_begin,
+		std::size_t const a_end,
+		TValue a_identity,
+		TFunction a_function,
+		TReduce a_reduce,
+		std::size_t const a_grainSize = 0)
+	{
+		detail::chunked_range const range{ a_begin, a_end, a_grainSize, a_worker.get_thread_count() };
+		if (range.get_chunk_count() == 0)
+		{
+			return a_identity;
+		}
+
+		std::vector<std::optional<TValue>> chunkResults(range.get_chunk_count());
+		a_worker.execute_on_all_threads(
+			detail::parallel_reduce_task<TValue, TFunction>{
+				range, a_identity, a_function, chunkResults });
+
+		auto result = std::move(*chunkResults.front());
+		for (auto it = std::next(chunkResults.begin()); it != chunkResults.end(); ++it)
+		{
+			result = a_reduce(std::move(result), std::move(**it));
+		}
+		return result;
+	}
+}
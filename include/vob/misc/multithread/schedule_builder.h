@@ -0,0 +1,222 @@
+#pragma once
+
+#include "worker.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <queue>
+#include <vector>
+
+
+namespace vob::mismt
+{
+	/// @brief Builds balanced schedules from a task dependency graph, using critical-path list scheduling: ready tasks
+	/// are assigned by decreasing length of the longest path to the end of the graph, each to the thread it can start
+	/// the earliest on.
+	/// Task costs are estimates that can be refined with the durations measured by a worker between executions.
+	template <typename TAllocator>
+	class basic_schedule_builder
+	{
+		// Types
+		template <typename TValue>
+		using rebind = typename std::allocator_traits<TAllocator>::template rebind_alloc<TValue>;
+
+		using task_id_list = std::vector<task_id, TAllocator>;
+
+		struct task_node
+		{
+			std::chrono::nanoseconds m_cost;
+			task_id_list m_dependencies;
+		};
+
+		using task_node_allocator = rebind<task_node>;
+		using duration_list = std::vector<std::chrono::nanoseconds, rebind<std::chrono::nanoseconds>>;
+
+	public:
+		// Types
+		using schedule = basic_schedule<TAllocator>;
+		using thread_schedule = basic_thread_schedule<TAllocator>;
+		using task_description = basic_task_description<TAllocator>;
+
+		// Constructors
+		explicit basic_schedule_builder(TAllocator const& a_allocator = {})
+			: m_tasks{ task_node_allocator{ a_allocator } }
+		{}
+
+		// Methods
+		/// @brief Adds a task to the graph and returns its id, which is its index in the task span to execute.
+		task_id add_task(std::chrono::nanoseconds const a_estimatedCost = std::chrono::nanoseconds{ 1 })
+		{
+			m_tasks.push_back(task_node{ a_estimatedCost, task_id_list{ get_allocator() } });
+			return m_tasks.size() - 1;
+		}
+
+		/// @brief Makes a task wait for another one to be done before it starts.
+		void add_dependency(task_id const a_task, task_id const a_dependency)
+		{
+			assert(a_task < m_tasks.size() && a_dependency < m_tasks.size() && a_task != a_dependency);
+			m_tasks[a_task].m_dependencies.push_back(a_dependency);
+		}
+
+		[[nodiscard]] std::size_t get_task_count() const
+		{
+			return m_tasks.size();
+		}
+
+		[[nodiscard]] std::chrono::nanoseconds get_cost(task_id const a_task) const
+		{
+			return m_tasks[a_task].m_cost;
+		}
+
+		void set_cost(task_id const a_task, std::chrono::nanoseconds const a_cost)
+		{
+			m_tasks[a_task].m_cost = a_cost;
+		}
+
+		/// @brief Blends the durations measured by a worker during its last execution into the task costs.
+		/// A smoothing of 0 replaces the costs by the measured durations, a smoothing close to 1 makes them evolve
+		/// slowly so a single spike does not reshuffle the whole schedule.
+		template <typename TWorker>
+		void update_costs(TWorker const& a_worker, float const a_smoothing = 0.5f)
+		{
+			assert(a_smoothing >= 0.0f && a_smoothing < 1.0f);
+			for (auto id = task_id{ 0 }; id < m_tasks.size(); ++id)
+			{
+				auto const cost = static_cast<float>(m_tasks[id].m_cost.count());
+				auto const duration = static_cast<float>(a_worker.get_task_duration(id).count());
+				m_tasks[id].m_cost = std::chrono::nanoseconds{
+					static_cast<std::chrono::nanoseconds::rep>(a_smoothing * cost + (1.0f - a_smoothing) * duration) };
+			}
+		}
+
+		/// @brief Builds a schedule spreading the tasks over a given number of threads.
+		[[nodiscard]] schedule build(std::size_t const a_threadCount) const
+		{
+			assert(a_threadCount > 0);
+			auto const taskCount = m_tasks.size();
+			auto const allocator = get_allocator();
+
+			// Successors and predecessor counts
+			std::vector<task_id_list, rebind<task_id_list>> successors(taskCount, task_id_list{ allocator }, allocator);
+			std::vector<std::size_t, rebind<std::size_t>> pendingCounts(taskCount, 0, allocator);
+			for (auto id = task_id{ 0 }; id < taskCount; ++id)
+			{
+				for (auto const dependency : m_tasks[id].m_dependencies)
+				{
+					successors[dependency].push_back(id);
+				}
+				pendingCounts[id] = m_tasks[id].m_dependencies.size();
+			}
+
+			// Priorities: longest path from each task to the end of the graph, computed in reverse topological order
+			task_id_list order{ allocator };
+			order.reserve(taskCount);
+			{
+				auto remainingCounts = pendingCounts;
+				for (auto id = task_id{ 0 }; id < taskCount; ++id)
+				{
+					if (remainingCounts[id] == 0)
+					{
+						order.push_back(id);
+					}
+				}
+				for (auto i = 0u; i < order.size(); ++i)
+				{
+					for (auto const successor : successors[order[i]])
+					{
+						if (--remainingCounts[successor] == 0)
+						{
+							order.push_back(successor);
+						}
+					}
+				}
+				assert(order.size() == taskCount && "Task graph has a cycle.");
+			}
+			duration_list priorities(taskCount, std::chrono::nanoseconds{ 0 }, allocator);
+			for (auto it = order.rbegin(); it != order.rend(); ++it)
+			{
+				auto longestSuccessorPath = std::chrono::nanoseconds{ 0 };
+				for (auto const successor : successors[*it])
+				{
+					longestSuccessorPath = std::max(longestSuccessorPath, priorities[successor]);
+				}
+				priorities[*it] = m_tasks[*it].m_cost + longestSuccessorPath;
+			}
+
+			// List scheduling
+			auto const hasLowerPriority = [&priorities](task_id const a_lhs, task_id const a_rhs)
+			{
+				return priorities[a_lhs] < priorities[a_rhs]
+					|| (priorities[a_lhs] == priorities[a_rhs] && a_lhs > a_rhs);
+			};
+			std::priority_queue<task_id, task_id_list, decltype(hasLowerPriority)> readyTasks{
+				hasLowerPriority, task_id_list{ allocator } };
+			for (auto id = task_id{ 0 }; id < taskCount; ++id)
+			{
+				if (pendingCounts[id] == 0)
+				{
+					readyTasks.push(id);
+				}
+			}
+
+			schedule result(a_threadCount, thread_schedule{ allocator }, allocator);
+			duration_list threadEndTimes(a_threadCount, std::chrono::nanoseconds{ 0 }, allocator);
+			duration_list taskEndTimes(taskCount, std::chrono::nanoseconds{ 0 }, allocator);
+			while (!readyTasks.empty())
+			{
+				auto const id = readyTasks.top();
+				readyTasks.pop();
+
+				auto dependenciesEndTime = std::chrono::nanoseconds{ 0 };
+				for (auto const dependency : m_tasks[id].m_dependencies)
+				{
+					dependenciesEndTime = std::max(dependenciesEndTime, taskEndTimes[dependency]);
+				}
+
+				auto bestThread = std::size_t{ 0 };
+				auto bestStartTime = std::max(threadEndTimes[0], dependenciesEndTime);
+				for (auto thread = std::size_t{ 1 }; thread < a_threadCount; ++thread)
+				{
+					auto const startTime = std::max(threadEndTimes[thread], dependenciesEndTime);
+					if (startTime < bestStartTime)
+					{
+						bestThread = thread;
+						bestStartTime = startTime;
+					}
+				}
+
+				taskEndTimes[id] = bestStartTime + m_tasks[id].m_cost;
+				threadEndTimes[bestThread] = taskEndTimes[id];
+				result[bestThread].push_back(task_description{ id, m_tasks[id].m_dependencies });
+
+				for (auto const successor : successors[id])
+				{
+					if (--pendingCounts[successor] == 0)
+					{
+						readyTasks.push(successor);
+					}
+				}
+			}
+			return result;
+		}
+
+		[[nodiscard]] TAllocator get_allocator() const
+		{
+			return TAllocator{ m_tasks.get_allocator() };
+		}
+
+	private:
+		// Attributes
+		std::vector<task_node, task_node_allocator> m_tasks;
+	};
+
+	using schedule_builder = basic_schedule_builder<std::allocator<task_id>>;
+
+	namespace pmr
+	{
+		using schedule_builder = basic_schedule_builder<std::pmr::polymorphic_allocator<task_id>>;
+	}
+}
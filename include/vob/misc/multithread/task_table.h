@@ -0,0 +1,232 @@
+#pragma once
+
+#include "basic_task.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+
+namespace vob::mismt
+{
+	/// @brief Stores tasks by value in a contiguous array of cache line sized entries, instead of each in its own
+	/// allocation behind a shared_ptr.
+	/// A task is any callable invocable on a const reference. Callables small enough are stored inside their entry,
+	/// larger ones are allocated with the table allocator. Executing a task is a single indirect call, without any
+	/// reference counting.
+	/// A callable can also provide std::optional<std::uint64_t> get_input_version() const, see
+	/// basic_task::get_input_version.
+	template <typename TAllocator>
+	class basic_task_table
+	{
+		// Constants
+		static constexpr std::size_t s_entrySize = 64;
+
+		// Types
+		using execute_function = void (*)(std::byte const*);
+		using input_version_function = std::optional<std::uint64_t> (*)(std::byte const*);
+		/// @brief Moves a callable to another buffer when given one, otherwise destroys it.
+		using manage_function = void (*)(std::byte*, std::byte*, TAllocator&);
+
+		struct alignas(s_entrySize) task_entry
+		{
+			// Constants
+			static constexpr std::size_t s_bufferSize = s_entrySize - 3 * sizeof(void*);
+
+			// Attributes
+			execute_function m_execute = nullptr;
+			input_version_function m_getInputVersion = nullptr;
+			manage_function m_manage = nullptr;
+			alignas(void*) std::byte m_buffer[s_bufferSize];
+		};
+
+		static_assert(sizeof(task_entry) == s_entrySize);
+
+		using task_entry_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<task_entry>;
+		using task_entry_traits = std::allocator_traits<task_entry_allocator>;
+
+	public:
+		// Constructors
+		explicit basic_task_table(TAllocator const& a_allocator = {})
+			: m_allocator{ a_allocator }
+		{}
+
+		basic_task_table(basic_task_table&&) = delete;
+
+		basic_task_table(basic_task_table const&) = delete;
+
+		~basic_task_table()
+		{
+			clear();
+			if (m_entries != nullptr)
+			{
+				task_entry_allocator entryAllocator{ m_allocator };
+				task_entry_traits::deallocate(entryAllocator, m_entries, m_capacity);
+			}
+		}
+
+		// Methods
+		/// @brief Adds a task to the table and returns its id. Must not be called while a worker executes it.
+		template <typename TFunction>
+		task_id add(TFunction&& a_function)
+		{
+			using function = std::decay_t<TFunction>;
+			static_assert(std::is_invocable_v<function const&>, "Tasks must be invocable on a const reference.");
+			constexpr auto isStoredInline = sizeof(function) <= task_entry::s_bufferSize
+				&& alignof(function) <= alignof(void*)
+				&& std::is_nothrow_move_constructible_v<function>;
+
+			if (m_size == m_capacity)
+			{
+				grow(std::max<std::size_t>(16, 2 * m_capacity));
+			}
+			auto& entry = *::new (m_entries + m_size) task_entry{};
+			if constexpr (isStoredInline)
+			{
+				::new (entry.m_buffer) function(std::forward<TFunction>(a_function));
+				entry.m_manage = [](std::byte* const a_buffer, std::byte* const a_destination, TAllocator&)
+				{
+					auto& object = *std::launder(reinterpret_cast<function*>(a_buffer));
+					if (a_destination != nullptr)
+					{
+						::new (a_destination) function(std::move(object));
+					}
+					object.~function();
+				};
+			}
+			else
+			{
+				using function_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<function>;
+				function_allocator allocator{ m_allocator };
+				auto const object = std::allocator_traits<function_allocator>::allocate(allocator, 1);
+				std::allocator_traits<function_allocator>::construct(
+					allocator, object, std::forward<TFunction>(a_function));
+				::new (entry.m_buffer) function*(object);
+				entry.m_manage = [](std::byte* const a_buffer, std::byte* const a_destination, TAllocator& a_allocator)
+				{
+					auto const storedObject = *std::launder(reinterpret_cast<function**>(a_buffer));
+					if (a_destination != nullptr)
+					{
+						::new (a_destination) function*(storedObject);
+						return;
+					}
+					function_allocator storedAllocator{ a_allocator };
+					std::allocator_traits<function_allocator>::destroy(storedAllocator, storedObject);
+					std::allocator_traits<function_allocator>::deallocate(storedAllocator, storedObject, 1);
+				};
+			}
+
+			entry.m_execute = [](std::byte const* const a_buffer)
+			{
+				get_function<function, isStoredInline>(a_buffer)();
+			};
+			if constexpr (requires (function const& a_task) { a_task.get_input_version(); })
+			{
+				entry.m_getInputVersion = [](std::byte const* const a_buffer) -> std::optional<std::uint64_t>
+				{
+					return get_function<function, isStoredInline>(a_buffer).get_input_version();
+				};
+			}
+			return m_size++;
+		}
+
+		void execute(task_id const a_id) const
+		{
+			auto const& entry = m_entries[a_id];
+			entry.m_execute(entry.m_buffer);
+		}
+
+		[[nodiscard]] std::optional<std::uint64_t> get_input_version(task_id const a_id) const
+		{
+			auto const& entry = m_entries[a_id];
+			return entry.m_getInputVersion != nullptr ? entry.m_getInputVersion(entry.m_buffer) : std::nullopt;
+		}
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return m_size;
+		}
+
+		void reserve(std::size_t const a_taskCount)
+		{
+			if (a_taskCount > m_capacity)
+			{
+				grow(a_taskCount);
+			}
+		}
+
+		void clear()
+		{
+			for (auto i = 0u; i < m_size; ++i)
+			{
+				m_entries[i].m_manage(m_entries[i].m_buffer, nullptr, m_allocator);
+			}
+			m_size = 0;
+		}
+
+		[[nodiscard]] TAllocator get_allocator() const
+		{
+			return m_allocator;
+		}
+
+		// Operators
+		basic_task_table& operator=(basic_task_table&&) = delete;
+		basic_task_table& operator=(basic_task_table const&) = delete;
+
+	private:
+		// Attributes
+		TAllocator m_allocator;
+		task_entry* m_entries = nullptr;
+		std::size_t m_size = 0;
+		std::size_t m_capacity = 0;
+
+		// Methods
+		template <typename TFunction, bool t_isStoredInline>
+		static TFunction const& get_function(std::byte const* const a_buffer)
+		{
+			if constexpr (t_isStoredInline)
+			{
+				return *std::launder(reinterpret_cast<TFunction const*>(a_buffer));
+			}
+			else
+			{
+				return **std::launder(reinterpret_cast<TFunction* const*>(a_buffer));
+			}
+		}
+
+		/// @brief Moves entries to a larger array, relocating the callables they store.
+		void grow(std::size_t const a_capacity)
+		{
+			task_entry_allocator entryAllocator{ m_allocator };
+			auto const entries = task_entry_traits::allocate(entryAllocator, a_capacity);
+			for (auto i = 0u; i < m_size; ++i)
+			{
+				auto& entry = m_entries[i];
+				auto& newEntry = *::new (entries + i) task_entry{};
+				newEntry.m_execute = entry.m_execute;
+				newEntry.m_getInputVersion = entry.m_getInputVersion;
+				newEntry.m_manage = entry.m_manage;
+				entry.m_manage(entry.m_buffer, newEntry.m_buffer, m_allocator);
+			}
+			if (m_entries != nullptr)
+			{
+				task_entry_traits::deallocate(entryAllocator, m_entries, m_capacity);
+			}
+			m_entries = entries;
+			m_capacity = a_capacity;
+		}
+	};
+
+	using task_table = basic_task_table<std::allocator<void>>;
+
+	namespace pmr
+	{
+		using task_table = basic_task_table<std::pmr::polymorphic_allocator<void>>;
+	}
+}
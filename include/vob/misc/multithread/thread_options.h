@@ -0,0 +1,150 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <fstream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace vob::mismt
+{
+	enum class thread_priority
+	{
+		Lowest,
+		Low,
+		Normal,
+		High,
+		Highest
+	};
+
+	/// @brief How a thread of a worker should be placed and scheduled by the operating system.
+	struct thread_options
+	{
+		/// @brief The logical core the thread is pinned to, if any.
+		std::optional<std::size_t> m_core;
+		/// @brief The NUMA node whose cores the thread is restricted to when it is not pinned to a core.
+		std::optional<std::size_t> m_numaNode;
+		/// @brief Raising the priority above Normal usually requires elevated rights.
+		thread_priority m_priority = thread_priority::Normal;
+		/// @brief The name shown by debuggers and profilers. Truncated to 15 characters on Linux.
+		std::string m_name;
+	};
+
+	namespace detail
+	{
+#if defined(__linux__)
+		/// @brief Adds the cores of a NUMA node to a set, as listed in sysfs (ex: "0-7,16-23").
+		inline void add_numa_node_cores(std::size_t const a_numaNode, cpu_set_t& a_cores)
+		{
+			std::ifstream cpuList{ "/sys/devices/system/node/node" + std::to_string(a_numaNode) + "/cpulist" };
+			std::size_t first, last;
+			while (cpuList >> first)
+			{
+				last = first;
+				if (cpuList.peek() == '-')
+				{
+					cpuList.ignore();
+					cpuList >> last;
+				}
+				for (auto core = first; core <= last && core < CPU_SETSIZE; ++core)
+				{
+					CPU_SET(core, &a_cores);
+				}
+				if (cpuList.peek() == ',')
+				{
+					cpuList.ignore();
+				}
+			}
+		}
+#endif
+	}
+
+	/// @brief Applies options to the calling thread, returning false if any of them could not be applied.
+	inline bool apply_to_current_thread(thread_options const& a_options)
+	{
+		auto succeeded = true;
+#if defined(_WIN32)
+		if (a_options.m_core.has_value())
+		{
+			GROUP_AFFINITY affinity{};
+			affinity.Group = static_cast<WORD>(*a_options.m_core / 64);
+			affinity.Mask = KAFFINITY{ 1 } << (*a_options.m_core % 64);
+			succeeded &= SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+		}
+		else if (a_options.m_numaNode.has_value())
+		{
+			GROUP_AFFINITY affinity{};
+			succeeded &= GetNumaNodeProcessorMaskEx(static_cast<USHORT>(*a_options.m_numaNode), &affinity) != 0
+				&& SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+		}
+
+		constexpr int priorities[] = {
+			THREAD_PRIORITY_LOWEST,
+			THREAD_PRIORITY_BELOW_NORMAL,
+			THREAD_PRIORITY_NORMAL,
+			THREAD_PRIORITY_ABOVE_NORMAL,
+			THREAD_PRIORITY_HIGHEST
+		};
+		if (a_options.m_priority != thread_priority::Normal)
+		{
+			succeeded &= SetThreadPriority(
+				GetCurrentThread(), priorities[static_cast<std::size_t>(a_options.m_priority)]) != 0;
+		}
+
+		if (!a_options.m_name.empty())
+		{
+			std::wstring const name{ a_options.m_name.begin(), a_options.m_name.end() };
+			succeeded &= SUCCEEDED(SetThreadDescription(GetCurrentThread(), name.c_str()));
+		}
+#elif defined(__linux__)
+		if (a_options.m_core.has_value() || a_options.m_numaNode.has_value())
+		{
+			cpu_set_t cores;
+			CPU_ZERO(&cores);
+			if (a_options.m_core.has_value() && *a_options.m_core < CPU_SETSIZE)
+			{
+				CPU_SET(*a_options.m_core, &cores);
+			}
+			else if (!a_options.m_core.has_value())
+			{
+				detail::add_numa_node_cores(*a_options.m_numaNode, cores);
+			}
+			succeeded &= CPU_COUNT(&cores) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cores), &cores) == 0;
+		}
+
+		// Threads are scheduled with SCHED_OTHER, whose only per-thread priority is the nice value
+		constexpr int niceValues[] = { 19, 10, 0, -5, -10 };
+		if (a_options.m_priority != thread_priority::Normal)
+		{
+			succeeded &= setpriority(
+				PRIO_PROCESS,
+				static_cast<id_t>(syscall(SYS_gettid)),
+				niceValues[static_cast<std::size_t>(a_options.m_priority)]) == 0;
+		}
+
+		if (!a_options.m_name.empty())
+		{
+			succeeded &= pthread_setname_np(pthread_self(), a_options.m_name.substr(0, 15).c_str()) == 0;
+		}
+#else
+		succeeded = !a_options.m_core.has_value()
+			&& !a_options.m_numaNode.has_value()
+			&& a_options.m_priority == thread_priority::Normal
+			&& a_options.m_name.empty();
+#endif
+		return succeeded;
+	}
+}
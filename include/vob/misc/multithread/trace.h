@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <ostream>
+#include <vector>
+
+#ifndef VOB_MISMT_TRACE
+#define VOB_MISMT_TRACE 0
+#endif
+
+
+namespace vob::mismt
+{
+	/// @brief When a task started waiting for its dependencies, started executing and was done, during an execution.
+	struct task_trace_event
+	{
+		std::size_t m_id;
+		std::chrono::steady_clock::time_point m_waitStart;
+		std::chrono::steady_clock::time_point m_start;
+		std::chrono::steady_clock::time_point m_end;
+	};
+
+	namespace detail
+	{
+#if VOB_MISMT_TRACE
+		/// @brief The events recorded by a single thread, so recording never contends with other threads.
+		template <typename TAllocator>
+		class basic_trace_lane
+		{
+			// Types
+			using event_allocator =
+				typename std::allocator_traits<TAllocator>::template rebind_alloc<task_trace_event>;
+
+		public:
+			// Constructors
+			explicit basic_trace_lane(TAllocator const& a_allocator = {})
+				: m_events{ event_allocator{ a_allocator } }
+			{}
+
+			// Methods
+			void record(task_trace_event const& a_event)
+			{
+				m_events.push_back(a_event);
+			}
+
+			void clear()
+			{
+				m_events.clear();
+			}
+
+			[[nodiscard]] auto const& get_events() const
+			{
+				return m_events;
+			}
+
+		private:
+			// Attributes
+			std::vector<task_trace_event, event_allocator> m_events;
+		};
+#else
+		/// @brief Stands for a trace lane when tracing is disabled, so it costs nothing.
+		template <typename TAllocator>
+		class basic_trace_lane
+		{
+		};
+
+		/// @brief Stands for a trace when tracing is disabled, so it costs nothing.
+		template <typename TAllocator>
+		class basic_disabled_trace
+		{
+		public:
+			// Constructors
+			explicit basic_disabled_trace(
+				[[maybe_unused]] std::size_t const a_laneCount,
+				[[maybe_unused]] TAllocator const& a_allocator = {})
+			{}
+
+			// Methods
+			basic_trace_lane<TAllocator>& get_lane([[maybe_unused]] std::size_t const a_lane)
+			{
+				return m_lane;
+			}
+
+		private:
+			// Attributes
+			basic_trace_lane<TAllocator> m_lane;
+		};
+#endif
+	}
+
+#if VOB_MISMT_TRACE
+	/// @brief The task events recorded by each thread of a worker, over the executions since it was last cleared.
+	/// Only available when VOB_MISMT_TRACE is set to 1.
+	template <typename TAllocator>
+	class basic_trace
+	{
+		// Types
+		using trace_lane = detail::basic_trace_lane<TAllocator>;
+		using trace_lane_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<trace_lane>;
+
+	public:
+		// Constructors
+		explicit basic_trace(std::size_t const a_laneCount, TAllocator const& a_allocator = {})
+			: m_lanes{ trace_lane_allocator{ a_allocator } }
+		{
+			m_lanes.reserve(a_laneCount);
+			for (auto i = 0u; i < a_laneCount; ++i)
+			{
+				m_lanes.emplace_back(a_allocator);
+			}
+		}
+
+		// Methods
+		[[nodiscard]] std::size_t get_lane_count() const
+		{
+			return m_lanes.size();
+		}
+
+		[[nodiscard]] trace_lane const& get_lane(std::size_t const a_lane) const
+		{
+			return m_lanes[a_lane];
+		}
+
+		[[nodiscard]] trace_lane& get_lane(std::size_t const a_lane)
+		{
+			return m_lanes[a_lane];
+		}
+
+		/// @brief Drops recorded events. Must not be called while the worker is executing.
+		void clear()
+		{
+			for (auto& lane : m_lanes)
+			{
+				lane.clear();
+			}
+		}
+
+		/// @brief Writes recorded events in the Chrome trace event format (chrome://tracing, Perfetto), one thread
+		/// per lane. Time spent waiting for dependencies appears as a separate "wait" event before each task.
+		void write_chrome_trace(std::ostream& a_outputStream) const
+		{
+			auto origin = std::chrono::steady_clock::time_point::max();
+			for (auto const& lane : m_lanes)
+			{
+				for (auto const& event : lane.get_events())
+				{
+					origin = std::min(origin, event.m_waitStart);
+				}
+			}
+
+			auto const toMicroseconds = [](std::chrono::steady_clock::duration const a_duration)
+			{
+				return std::chrono::duration<double, std::micro>{ a_duration }.count();
+			};
+
+			auto isFirst = true;
+			auto const writeEvent = [&](
+				char const* const a_category,
+				std::size_t const a_lane,
+				std::size_t const a_id,
+				std::chrono::steady_clock::time_point const a_start,
+				std::chrono::steady_clock::time_point const a_end)
+			{
+				a_outputStream << (isFirst ? "\n" : ",\n")
+					<< "{\"name\":\"" << a_category << ' ' << a_id
+					<< "\",\"cat\":\"" << a_category
+					<< "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << a_lane
+					<< ",\"ts\":" << toMicroseconds(a_start - origin)
+					<< ",\"dur\":" << toMicroseconds(a_end - a_start)
+					<< ",\"args\":{\"task\":" << a_id << "}}";
+				isFirst = false;
+			};
+
+			a_outputStream << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+			for (auto lane = 0u; lane < m_lanes.size(); ++lane)
+			{
+				for (auto const& event : m_lanes[lane].get_events())
+				{
+					if (event.m_start > event.m_waitStart)
+					{
+						writeEvent("wait", lane, event.m_id, event.m_waitStart, event.m_start);
+					}
+					writeEvent("task", lane, event.m_id, event.m_start, event.m_end);
+				}
+			}
+			a_outputStream << "\n]}\n";
+		}
+
+	private:
+		// Attributes
+		std::vector<trace_lane, trace_lane_allocator> m_lanes;
+	};
+
+	using trace = basic_trace<std::allocator<void>>;
+
+	namespace pmr
+	{
+		using trace = basic_trace<std::pmr::polymorphic_allocator<void>>;
+	}
+#endif
+}
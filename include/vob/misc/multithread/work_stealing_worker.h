@@ -0,0 +1,469 @@
+#pragma once
+
+#include "coroutine_task.h"
+#include "worker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+namespace vob::mismt
+{
+	namespace detail
+	{
+		/// @brief A fixed capacity Chase-Lev deque of task ids, reset between executions.
+		/// Its owner pushes and pops at the bottom while other threads steal from the top. As a task is never in two
+		/// deques at once, a capacity of the task count is enough.
+		template <typename TAllocator>
+		class basic_task_deque
+		{
+			// Types
+			using buffer_allocator =
+				typename std::allocator_traits<TAllocator>::template rebind_alloc<std::atomic<task_id>>;
+
+		public:
+			// Constructors
+			basic_task_deque(std::size_t const a_capacity, TAllocator const& a_allocator = {})
+				: m_buffer(std::bit_ceil(std::max<std::size_t>(a_capacity, 1)), buffer_allocator{ a_allocator })
+			{}
+
+			// Methods
+			void reset()
+			{
+				m_top.store(0, std::memory_order_relaxed);
+				m_bottom.store(0, std::memory_order_relaxed);
+			}
+
+			/// @brief Pushes a task at the bottom of the deque. Must only be called by the owner.
+			void push(task_id const a_id)
+			{
+				auto const bottom = m_bottom.load(std::memory_order_relaxed);
+				assert(static_cast<std::size_t>(bottom - m_top.load(std::memory_order_relaxed)) < m_buffer.size());
+				m_buffer[bottom & get_mask()].store(a_id, std::memory_order_relaxed);
+				m_bottom.store(bottom + 1, std::memory_order_release);
+			}
+
+			/// @brief Pops the task at the bottom of the deque. Must only be called by the owner.
+			bool pop(task_id& a_id)
+			{
+				auto const bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+				m_bottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				auto top = m_top.load(std::memory_order_relaxed);
+				if (top > bottom)
+				{
+					m_bottom.store(bottom + 1, std::memory_order_relaxed);
+					return false;
+				}
+
+				a_id = m_buffer[bottom & get_mask()].load(std::memory_order_relaxed);
+				if (top < bottom)
+				{
+					return true;
+				}
+
+				// Last task: race against thieves
+				auto const won = m_top.compare_exchange_strong(
+					top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+				m_bottom.store(bottom + 1, std::memory_order_relaxed);
+				return won;
+			}
+
+			/// @brief Steals the task at the top of the deque. Can be called by any thread.
+			bool steal(task_id& a_id)
+			{
+				auto top = m_top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				auto const bottom = m_bottom.load(std::memory_order_acquire);
+				if (top >= bottom)
+				{
+					return false;
+				}
+
+				a_id = m_buffer[top & get_mask()].load(std::memory_order_relaxed);
+				return m_top.compare_exchange_strong(
+					top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			}
+
+		private:
+			// Attributes
+			alignas(64) std::atomic<std::int64_t> m_top = 0;
+			alignas(64) std::atomic<std::int64_t> m_bottom = 0;
+			std::vector<std::atomic<task_id>, buffer_allocator> m_buffer;
+
+			// Methods
+			std::int64_t get_mask() const
+			{
+				return static_cast<std::int64_t>(m_buffer.size() - 1);
+			}
+		};
+
+		/// @brief What a work-stealing worker tracks about a task, besides its dependencies.
+		struct task_slot
+		{
+			// Constants
+			static constexpr std::uintptr_t s_done = 1;
+
+			// Attributes
+			/// @brief The coroutines waiting for the task to be done, or s_done once it is.
+			std::atomic<std::uintptr_t> m_waiters = 0;
+			/// @brief The coroutine of the task when it is suspended.
+			std::coroutine_handle<> m_handle;
+			/// @brief The thread the task last executed on.
+			std::size_t m_lane = 0;
+		};
+	}
+
+	/// @brief A worker executing tasks dynamically: a task becomes ready as soon as its last dependency is done, and
+	/// idle threads steal ready tasks from busy ones.
+	/// The schedule only provides the dependencies of each task and the thread its execution starts on when it has
+	/// no dependency, so a slow task never stalls the tasks that were scheduled after it on the same thread.
+	/// Coroutine tasks that wait for another task or yield are suspended, and resumed by whichever thread picks them
+	/// up once they are ready again: a task being done makes the coroutines waiting for it ready.
+	template <typename TScheduleAllocator, typename TAllocator>
+	class basic_work_stealing_worker final
+		: private detail::coroutine_scheduler
+	{
+		// Types
+		class lane
+		{
+		public:
+			// Constructors
+			lane(basic_work_stealing_worker& a_worker, std::size_t const a_index)
+				: m_worker{ a_worker }
+				, m_index{ a_index }
+			{}
+
+			// Methods
+			void execute(std::size_t)
+			{
+				m_worker.execute_lane(m_index);
+			}
+
+		private:
+			// Attributes
+			basic_work_stealing_worker& m_worker;
+			std::size_t m_index;
+		};
+
+		using dependency_table = detail::basic_dependency_table<TAllocator>;
+		using task_deque = detail::basic_task_deque<TAllocator>;
+		using task_deque_allocator =
+			typename std::allocator_traits<TAllocator>::template rebind_alloc<std::shared_ptr<task_deque>>;
+		using task_deque_list = std::vector<std::shared_ptr<task_deque>, task_deque_allocator>;
+		using pending_count_allocator =
+			typename std::allocator_traits<TAllocator>::template rebind_alloc<std::atomic<std::uint32_t>>;
+		using pending_count_list = std::vector<std::atomic<std::uint32_t>, pending_count_allocator>;
+		using task_slot_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<detail::task_slot>;
+		using task_slot_list = std::vector<detail::task_slot, task_slot_allocator>;
+		using coroutine_task_allocator =
+			typename std::allocator_traits<TAllocator>::template rebind_alloc<basic_coroutine_task const*>;
+		using coroutine_task_list = std::vector<basic_coroutine_task const*, coroutine_task_allocator>;
+		using root_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<task_id>;
+		using root_list = std::vector<task_id, root_allocator>;
+		using root_list_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<root_list>;
+		using thread_worker = detail::basic_thread_worker<lane>;
+		using thread_worker_allocator =
+			typename std::allocator_traits<TAllocator>::template rebind_alloc<std::shared_ptr<thread_worker>>;
+		using thread_worker_list = std::vector<std::shared_ptr<thread_worker>, thread_worker_allocator>;
+
+	public:
+		// Types
+		using schedule = basic_schedule<TScheduleAllocator>;
+		using thread_schedule = basic_thread_schedule<TScheduleAllocator>;
+
+		// Constructors
+		basic_work_stealing_worker(basic_work_stealing_worker&&) = delete;
+
+		basic_work_stealing_worker(basic_work_stealing_worker const&) = delete;
+
+		/// @brief Creates a worker with a thread per lane of a schedule, the first lane being executed by the thread
+		/// calling execute.
+		/// Thread options apply to the lane with the same index, those of the first lane to the calling thread.
+		basic_work_stealing_worker(
+			task_span const& a_tasks,
+			schedule const& a_schedule,
+			std::span<thread_options const> const a_threadOptions = {},
+			TAllocator const& a_allocator = {})
+			: m_tasks{ a_tasks }
+			, m_dependencies{ a_tasks.size(), a_schedule, a_allocator }
+			, m_pendingCounts(a_tasks.size(), pending_count_allocator{ a_allocator })
+			, m_slots(a_tasks.size(), task_slot_allocator{ a_allocator })
+			, m_coroutineTasks{ coroutine_task_allocator{ a_allocator } }
+			, m_roots{ root_list_allocator{ a_allocator } }
+			, m_deques{ task_deque_allocator{ a_allocator } }
+			, m_yieldedTasks{ root_list_allocator{ a_allocator } }
+			, m_threadWorkers{ thread_worker_allocator{ a_allocator } }
+		{
+			assert(!a_schedule.empty());
+			if (!a_threadOptions.empty())
+			{
+				apply_to_current_thread(a_threadOptions.front());
+			}
+
+			m_coroutineTasks.reserve(a_tasks.size());
+			for (auto const& task : a_tasks)
+			{
+				m_coroutineTasks.push_back(dynamic_cast<basic_coroutine_task const*>(task.get()));
+			}
+
+			// Tasks without dependency start on the thread they were scheduled on. They are pushed in reverse order
+			// so that each thread pops them in scheduled order.
+			m_roots.reserve(a_schedule.size());
+			for (auto const& threadSchedule : a_schedule)
+			{
+				auto& roots = m_roots.emplace_back();
+				for (auto it = threadSchedule.rbegin(); it != threadSchedule.rend(); ++it)
+				{
+					if (it->m_dependencies.empty())
+					{
+						roots.push_back(it->m_id);
+					}
+				}
+			}
+
+			m_deques.reserve(a_schedule.size());
+			for (auto i = 0u; i < a_schedule.size(); ++i)
+			{
+				m_deques.emplace_back(std::allocate_shared<task_deque>(
+					m_deques.get_allocator(), a_tasks.size(), m_deques.get_allocator()));
+			}
+
+			m_yieldedTasks.resize(a_schedule.size());
+
+			m_threadWorkers.reserve(a_schedule.size() - 1);
+			for (auto i = 1u; i < a_schedule.size(); ++i)
+			{
+				m_threadWorkers.emplace_back(std::allocate_shared<thread_worker>(
+					m_threadWorkers.get_allocator(),
+					i < a_threadOptions.size() ? a_threadOptions[i] : thread_options{},
+					*this,
+					i));
+			}
+		}
+
+		~basic_work_stealing_worker() = default;
+
+		// Methods
+		void execute()
+		{
+			reset();
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->request_execute();
+			}
+			execute_lane(0);
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->wait_until_done();
+			}
+		}
+
+		/// @brief Provides the number of threads executing tasks, including the one calling execute.
+		[[nodiscard]] std::size_t get_thread_count() const
+		{
+			return m_threadWorkers.size() + 1;
+		}
+
+		/// @brief Executes a task once on each thread of this worker, including the calling one, and waits for all
+		/// of them to be done. Must not be called during an execution.
+		void execute_on_all_threads(basic_task const& a_task)
+		{
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->request_execute(a_task);
+			}
+			a_task.execute();
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->wait_until_done();
+			}
+		}
+
+		// Operators
+		basic_work_stealing_worker& operator=(basic_work_stealing_worker&&) = delete;
+
+		basic_work_stealing_worker& operator=(basic_work_stealing_worker const&) = delete;
+
+	private:
+		// Attributes
+		task_span const& m_tasks;
+		dependency_table m_dependencies;
+		pending_count_list m_pendingCounts;
+		task_slot_list m_slots;
+		coroutine_task_list m_coroutineTasks;
+		std::vector<root_list, root_list_allocator> m_roots;
+		task_deque_list m_deques;
+		std::vector<root_list, root_list_allocator> m_yieldedTasks;
+		alignas(64) std::atomic<std::size_t> m_remainingTaskCount = 0;
+		thread_worker_list m_threadWorkers;
+
+		// Methods
+		void reset()
+		{
+			for (auto i = 0u; i < m_pendingCounts.size(); ++i)
+			{
+				m_pendingCounts[i].store(m_dependencies.get_predecessor_count(i), std::memory_order_relaxed);
+				m_slots[i].m_waiters.store(0, std::memory_order_relaxed);
+				assert(!m_slots[i].m_handle);
+			}
+			for (auto i = 0u; i < m_deques.size(); ++i)
+			{
+				m_deques[i]->reset();
+				for (auto const root : m_roots[i])
+				{
+					m_deques[i]->push(root);
+				}
+			}
+			m_remainingTaskCount.store(m_dependencies.get_scheduled_task_count(), std::memory_order_relaxed);
+		}
+
+		void execute_lane(std::size_t const a_lane)
+		{
+			auto& deque = *m_deques[a_lane];
+			task_id id;
+			while (true)
+			{
+				if (deque.pop(id) || (push_yielded_tasks(a_lane) && deque.pop(id)) || steal(a_lane, id))
+				{
+					execute_task(a_lane, id);
+				}
+				else if (m_remainingTaskCount.load(std::memory_order_acquire) == 0)
+				{
+					return;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		bool steal(std::size_t const a_lane, task_id& a_id)
+		{
+			for (auto offset = 1u; offset < m_deques.size(); ++offset)
+			{
+				if (m_deques[(a_lane + offset) % m_deques.size()]->steal(a_id))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// @brief Makes tasks that yielded on a thread ready again, once it has nothing else to execute.
+		bool push_yielded_tasks(std::size_t const a_lane)
+		{
+			auto& yieldedTasks = m_yieldedTasks[a_lane];
+			if (yieldedTasks.empty())
+			{
+				return false;
+			}
+			for (auto it = yieldedTasks.rbegin(); it != yieldedTasks.rend(); ++it)
+			{
+				m_deques[a_lane]->push(*it);
+			}
+			yieldedTasks.clear();
+			return true;
+		}
+
+		void execute_task(std::size_t const a_lane, task_id const a_id)
+		{
+			auto& slot = m_slots[a_id];
+			slot.m_lane = a_lane;
+			if (auto const coroutineTask = m_coroutineTasks[a_id])
+			{
+				// Start or resume the coroutine, which completes the task itself when it reaches its end
+				auto handle = std::exchange(slot.m_handle, nullptr);
+				if (!handle)
+				{
+					auto typedHandle = coroutineTask->execute_async(task_context{ this, a_id }).release();
+					typedHandle.promise().set_scheduler(this, a_id);
+					handle = typedHandle;
+				}
+				handle.resume();
+				return;
+			}
+
+			m_tasks[a_id]->execute();
+			complete(a_id);
+		}
+
+		bool suspend_until_done(
+			std::size_t const a_id,
+			std::size_t const a_awaitedId,
+			std::coroutine_handle<> a_handle,
+			detail::task_waiter& a_waiter) override
+		{
+			auto& slot = m_slots[a_id];
+			auto& waiters = m_slots[a_awaitedId].m_waiters;
+			slot.m_handle = a_handle;
+			a_waiter.m_id = a_id;
+			auto head = waiters.load(std::memory_order_acquire);
+			do
+			{
+				if (head == detail::task_slot::s_done)
+				{
+					slot.m_handle = nullptr;
+					return false;
+				}
+				a_waiter.m_next = reinterpret_cast<detail::task_waiter*>(head);
+			} while (!waiters.compare_exchange_weak(
+				head,
+				reinterpret_cast<std::uintptr_t>(&a_waiter),
+				std::memory_order_release,
+				std::memory_order_acquire));
+			return true;
+		}
+
+		bool suspend_and_yield(std::size_t const a_id, std::coroutine_handle<> a_handle) override
+		{
+			auto& slot = m_slots[a_id];
+			slot.m_handle = a_handle;
+			m_yieldedTasks[slot.m_lane].push_back(a_id);
+			return true;
+		}
+
+		void complete(std::size_t const a_id) override
+		{
+			auto const ownLane = m_slots[a_id].m_lane;
+			for (auto const successor : m_dependencies.get_successors(a_id))
+			{
+				if (m_pendingCounts[successor].fetch_sub(1, std::memory_order_acq_rel) == 1)
+				{
+					m_deques[ownLane]->push(successor);
+				}
+			}
+
+			// A woken coroutine may resume on another thread and destroy its waiter right after being pushed
+			auto waiter = reinterpret_cast<detail::task_waiter*>(
+				m_slots[a_id].m_waiters.exchange(detail::task_slot::s_done, std::memory_order_acq_rel));
+			while (waiter != nullptr)
+			{
+				auto const next = waiter->m_next;
+				m_deques[ownLane]->push(waiter->m_id);
+				waiter = next;
+			}
+
+			m_remainingTaskCount.fetch_sub(1, std::memory_order_acq_rel);
+		}
+	};
+
+	using work_stealing_worker = basic_work_stealing_worker<std::allocator<task_id>, std::allocator<void>>;
+
+	namespace pmr
+	{
+		using work_stealing_worker = basic_work_stealing_worker<
+			std::pmr::polymorphic_allocator<task_id>,
+			std::pmr::polymorphic_allocator<void>
+		>;
+	}
+}
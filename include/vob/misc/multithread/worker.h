@@ -1,16 +1,39 @@
 #pragma once
 
 #include "basic_task.h"
+#include "task_table.h"
+#include "thread_options.h"
+#include "trace.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <mutex>
+#include <optional>
+#include <span>
 #include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 namespace vob::mismt
 {
-	using task_id = std::size_t;
+	enum class execution_mode
+	{
+		/// @brief Every scheduled task executes.
+		Full,
+		/// @brief Tasks whose input version did not change and whose dependencies were all skipped are skipped.
+		Incremental
+	};
 
 	template <typename TAllocator>
 	struct basic_task_description
@@ -39,58 +62,381 @@ namespace vob::mismt
 
 	namespace detail
 	{
-		class task_state
+		/// @brief The dependency graph of a schedule, flattened so that each task knows how many tasks it waits for
+		/// and which tasks wait for it.
+		template <typename TAllocator>
+		class basic_dependency_table
 		{
+			// Types
+			using count_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<std::uint32_t>;
+			using offset_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<std::size_t>;
+			using task_id_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<task_id>;
+
 		public:
+			// Constructors
+			template <typename TScheduleAllocator>
+			basic_dependency_table(
+				std::size_t const a_taskCount,
+				basic_schedule<TScheduleAllocator> const& a_schedule,
+				TAllocator const& a_allocator = {})
+				: m_predecessorCounts(a_taskCount, 0, count_allocator{ a_allocator })
+				, m_successorOffsets(a_taskCount + 1, 0, offset_allocator{ a_allocator })
+				, m_successors{ task_id_allocator{ a_allocator } }
+			{
+				// Count predecessors and successors of each task
+				for (auto const& threadSchedule : a_schedule)
+				{
+					for (auto const& taskDescription : threadSchedule)
+					{
+						assert(taskDescription.m_id < a_taskCount);
+						m_predecessorCounts[taskDescription.m_id] =
+							static_cast<std::uint32_t>(taskDescription.m_dependencies.size());
+						for (auto const dependency : taskDescription.m_dependencies)
+						{
+							assert(dependency < a_taskCount);
+							++m_successorOffsets[dependency + 1];
+						}
+						++m_scheduledTaskCount;
+					}
+				}
+
+				// Turn successor counts into offsets and fill them
+				for (auto i = 0u; i < a_taskCount; ++i)
+				{
+					m_successorOffsets[i + 1] += m_successorOffsets[i];
+				}
+				m_successors.resize(m_successorOffsets[a_taskCount]);
+				std::vector<std::size_t, offset_allocator> cursors(
+					m_successorOffsets.begin(), m_successorOffsets.end() - 1, offset_allocator{ a_allocator });
+				for (auto const& threadSchedule : a_schedule)
+				{
+					for (auto const& taskDescription : threadSchedule)
+					{
+						for (auto const dependency : taskDescription.m_dependencies)
+						{
+							m_successors[cursors[dependency]++] = taskDescription.m_id;
+						}
+					}
+				}
+			}
+
 			// Methods
-			void wait_until_done()
+			[[nodiscard]] std::size_t get_task_count() const
 			{
-				std::unique_lock<std::mutex> lock{ m_mutex };
-				m_sync.wait(lock, [this]
+				return m_predecessorCounts.size();
+			}
+
+			[[nodiscard]] TAllocator get_allocator() const
+			{
+				return TAllocator{ m_predecessorCounts.get_allocator() };
+			}
+
+			[[nodiscard]] std::size_t get_scheduled_task_count() const
+			{
+				return m_scheduledTaskCount;
+			}
+
+			[[nodiscard]] std::uint32_t get_predecessor_count(task_id const a_id) const
+			{
+				return m_predecessorCounts[a_id];
+			}
+
+			[[nodiscard]] std::span<task_id const> get_successors(task_id const a_id) const
+			{
+				return std::span<task_id const>{
+					m_successors.data() + m_successorOffsets[a_id],
+					m_successors.data() + m_successorOffsets[a_id + 1] };
+			}
+
+		private:
+			// Attributes
+			std::vector<std::uint32_t, count_allocator> m_predecessorCounts;
+			std::vector<std::size_t, offset_allocator> m_successorOffsets;
+			std::vector<task_id, task_id_allocator> m_successors;
+			std::size_t m_scheduledTaskCount = 0;
+		};
+
+		/// @brief Hints the processor that the calling thread is spinning.
+		inline void spin_pause()
+		{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+			_mm_pause();
+#elif defined(__i386__) || defined(__x86_64__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+			asm volatile("yield");
+#else
+			std::this_thread::yield();
+#endif
+		}
+
+		/// @brief The number of predecessors of a task that are not done yet.
+		/// The last predecessor to finish makes the task ready. A thread waiting for a task to be ready spins for a
+		/// while before parking on the counter itself, so no mutex is ever involved.
+		/// States are stored contiguously, each on its own cache line so that threads updating the states of
+		/// neighbouring tasks do not contend.
+		class alignas(64) task_state
+		{
+		public:
+			// Methods
+			void reset(std::uint32_t const a_predecessorCount)
+			{
+				m_pendingCount.store(a_predecessorCount, std::memory_order_relaxed);
+				m_wasExecuted = false;
+			}
+
+			void wait_until_ready()
+			{
+				for (auto i = 0u; i < s_spinCount; ++i)
+				{
+					if ((m_pendingCount.load(std::memory_order_acquire) & ~s_parkedBit) == 0)
 					{
-						return m_isDone;
-					});
+						return;
+					}
+					spin_pause();
+				}
+
+				auto pendingCount = m_pendingCount.load(std::memory_order_acquire);
+				while ((pendingCount & ~s_parkedBit) != 0)
+				{
+					// Let the last predecessor know it has to wake this thread up
+					if ((pendingCount & s_parkedBit) == 0 && !m_pendingCount.compare_exchange_weak(
+						pendingCount, pendingCount | s_parkedBit, std::memory_order_acquire))
+					{
+						continue;
+					}
+					m_pendingCount.wait(pendingCount | s_parkedBit, std::memory_order_acquire);
+					pendingCount = m_pendingCount.load(std::memory_order_acquire);
+				}
 			}
 
-			void set_is_done(bool a_isDone)
+			void release_predecessor()
 			{
+				if (m_pendingCount.fetch_sub(1, std::memory_order_acq_rel) == (s_parkedBit | 1))
 				{
-					std::lock_guard<std::mutex> lock{ m_mutex };
-					m_isDone = a_isDone;
+					m_pendingCount.notify_all();
 				}
-				m_sync.notify_all();
+			}
+
+			/// @brief Whether the task executed during the current execution. Only meaningful to its successors once
+			/// they are ready, or once the execution is done.
+			[[nodiscard]] bool was_executed() const
+			{
+				return m_wasExecuted;
+			}
+
+			void set_executed()
+			{
+				m_wasExecuted = true;
 			}
 
 		private:
+			// Constants
+			static constexpr std::uint32_t s_parkedBit = 1u << 31;
+			static constexpr std::uint32_t s_spinCount = 1024;
+
 			// Attributes
-			bool m_isDone = true;
-			std::mutex m_mutex;
-			std::condition_variable m_sync;
+			std::atomic<std::uint32_t> m_pendingCount = 0;
+			bool m_wasExecuted = false;
 		};
 
 		template <typename TAllocator>
-		using basic_task_state_list = std::vector<std::shared_ptr<task_state>, TAllocator>;
+		using basic_task_state_list = std::vector<task_state, TAllocator>;
 
-		using task_state_list = basic_task_state_list<std::allocator<std::shared_ptr<task_state>>>;
+		using task_state_list = basic_task_state_list<std::allocator<task_state>>;
 
-		template <typename TScheduleAllocator, typename TTaskStateAllocator>
+		/// @brief What is known about a task from its previous executions. Only updated by the thread the task is
+		/// scheduled on, so consecutive executions never update it concurrently.
+		class alignas(64) task_record
+		{
+		public:
+			// Methods
+			[[nodiscard]] std::chrono::nanoseconds get_duration() const
+			{
+				return m_duration;
+			}
+
+			void set_duration(std::chrono::nanoseconds const a_duration)
+			{
+				m_duration = a_duration;
+			}
+
+			/// @brief Whether the task can be skipped given its current input version, assuming none of its
+			/// dependencies executed.
+			[[nodiscard]] bool is_up_to_date(std::optional<std::uint64_t> const& a_inputVersion) const
+			{
+				return a_inputVersion.has_value() && a_inputVersion == m_inputVersion;
+			}
+
+			void set_input_version(std::optional<std::uint64_t> const& a_inputVersion)
+			{
+				m_inputVersion = a_inputVersion;
+			}
+
+			/// @brief Forces the next incremental execution to execute the task.
+			void invalidate()
+			{
+				m_inputVersion.reset();
+			}
+
+		private:
+			// Attributes
+			std::chrono::nanoseconds m_duration{ 0 };
+			std::optional<std::uint64_t> m_inputVersion;
+		};
+
+		template <typename TAllocator>
+		using basic_task_record_list =
+			std::vector<task_record, typename std::allocator_traits<TAllocator>::template rebind_alloc<task_record>>;
+
+		/// @brief What an execution mutates. Workers keep several of them, so that an execution can start while the
+		/// previous one is still finishing.
+		template <typename TTaskStateAllocator>
+		struct basic_frame
+		{
+			basic_task_state_list<TTaskStateAllocator> m_taskStates;
+			execution_mode m_mode = execution_mode::Full;
+		};
+
+		template <typename TTaskStateAllocator>
+		using basic_frame_list = std::array<basic_frame<TTaskStateAllocator>, 2>;
+
+		inline void execute_task(task_span const& a_tasks, task_id const a_id)
+		{
+			a_tasks[a_id]->execute();
+		}
+
+		template <typename TAllocator>
+		void execute_task(basic_task_table<TAllocator> const& a_tasks, task_id const a_id)
+		{
+			a_tasks.execute(a_id);
+		}
+
+		inline std::optional<std::uint64_t> get_input_version(task_span const& a_tasks, task_id const a_id)
+		{
+			return a_tasks[a_id]->get_input_version();
+		}
+
+		template <typename TAllocator>
+		std::optional<std::uint64_t> get_input_version(basic_task_table<TAllocator> const& a_tasks, task_id const a_id)
+		{
+			return a_tasks.get_input_version(a_id);
+		}
+
+		template <
+			typename TScheduleAllocator,
+			typename TDependencyAllocator,
+			typename TTaskStateAllocator,
+			typename TTraceAllocator,
+			typename TTasks>
 		void execute_thread_schedule(
 			basic_thread_schedule<TScheduleAllocator> const& a_schedule,
-			task_span const& a_tasks,
-			basic_task_state_list<TTaskStateAllocator>& m_taskStates)
+			TTasks const& a_tasks,
+			basic_dependency_table<TDependencyAllocator> const& a_dependencies,
+			basic_task_state_list<TTaskStateAllocator>& a_taskStates,
+			basic_task_record_list<TTaskStateAllocator>& a_taskRecords,
+			[[maybe_unused]] basic_trace_lane<TTraceAllocator>& a_traceLane,
+			execution_mode const a_mode)
 		{
 			for (auto& taskDescription : a_schedule)
 			{
-				for (auto& dependency : taskDescription.m_dependencies)
+				auto& taskState = a_taskStates[taskDescription.m_id];
+				auto& taskRecord = a_taskRecords[taskDescription.m_id];
+#if VOB_MISMT_TRACE
+				auto const waitStart = std::chrono::steady_clock::now();
+#endif
+				taskState.wait_until_ready();
+				auto const inputVersion = get_input_version(a_tasks, taskDescription.m_id);
+				if (a_mode != execution_mode::Incremental
+					|| !taskRecord.is_up_to_date(inputVersion)
+					|| std::any_of(
+						taskDescription.m_dependencies.begin(),
+						taskDescription.m_dependencies.end(),
+						[&a_taskStates](task_id const a_dependency)
+						{
+							return a_taskStates[a_dependency].was_executed();
+						}))
+				{
+					auto const start = std::chrono::steady_clock::now();
+					execute_task(a_tasks, taskDescription.m_id);
+					auto const end = std::chrono::steady_clock::now();
+					taskState.set_executed();
+					taskRecord.set_duration(end - start);
+					taskRecord.set_input_version(inputVersion);
+#if VOB_MISMT_TRACE
+					a_traceLane.record(task_trace_event{ taskDescription.m_id, waitStart, start, end });
+#endif
+				}
+				for (auto const successor : a_dependencies.get_successors(taskDescription.m_id))
 				{
-					m_taskStates[dependency]->wait_until_done();
+					a_taskStates[successor].release_predecessor();
 				}
-				a_tasks[taskDescription.m_id]->execute();
-				m_taskStates[taskDescription.m_id]->set_is_done(true);
 			}
 		}
 
-		template <typename TScheduleAllocator, typename TTaskStateAllocator>
+		/// @brief A lane executing its part of a static schedule.
+		template <
+			typename TScheduleAllocator,
+			typename TDependencyAllocator,
+			typename TTaskStateAllocator,
+			typename TTraceAllocator,
+			typename TTasks>
+		class basic_schedule_lane
+		{
+		public:
+			// Constructors
+			basic_schedule_lane(
+				TTasks const& a_tasks,
+				basic_dependency_table<TDependencyAllocator> const& a_dependencies,
+				basic_frame_list<TTaskStateAllocator>& a_frames,
+				basic_task_record_list<TTaskStateAllocator>& a_taskRecords,
+				basic_trace_lane<TTraceAllocator>& a_traceLane,
+				basic_thread_schedule<TScheduleAllocator> a_schedule)
+				: m_tasks{ a_tasks }
+				, m_dependencies{ a_dependencies }
+				, m_frames{ a_frames }
+				, m_taskRecords{ a_taskRecords }
+				, m_traceLane{ a_traceLane }
+				, m_schedule{ std::move(a_schedule) }
+			{}
+
+			// Methods
+			void execute(std::size_t const a_frame)
+			{
+				auto& frame = m_frames[a_frame % m_frames.size()];
+				detail::execute_thread_schedule(
+					m_schedule,
+					m_tasks,
+					m_dependencies,
+					frame.m_taskStates,
+					m_taskRecords,
+					m_traceLane,
+					frame.m_mode);
+			}
+
+			[[nodiscard]] basic_thread_schedule<TScheduleAllocator> const& get_schedule() const
+			{
+				return m_schedule;
+			}
+
+			void set_schedule(basic_thread_schedule<TScheduleAllocator> a_schedule)
+			{
+				m_schedule = std::move(a_schedule);
+			}
+
+		private:
+			// Attributes
+			TTasks const& m_tasks;
+			basic_dependency_table<TDependencyAllocator> const& m_dependencies;
+			basic_frame_list<TTaskStateAllocator>& m_frames;
+			basic_task_record_list<TTaskStateAllocator>& m_taskRecords;
+			basic_trace_lane<TTraceAllocator>& m_traceLane;
+			basic_thread_schedule<TScheduleAllocator> m_schedule;
+		};
+
+		/// @brief A thread persisting between executions, running its lane for each frame it is requested to.
+		/// Frames are queued, so a thread can be requested the next frame before it is done with the current one.
+		template <typename TLane>
 		class basic_thread_worker
 		{
 		public:
@@ -101,105 +447,169 @@ namespace vob::mismt
 
 			basic_thread_worker(basic_thread_worker const&) = delete;
 
-			basic_thread_worker(
-				task_span const& a_tasks,
-				basic_task_state_list<TTaskStateAllocator>& a_taskStates,
-				basic_thread_schedule<TScheduleAllocator> a_schedule)
-				: m_tasks{ a_tasks }
-				, m_taskStates{ a_taskStates }
-				, m_schedule{ std::move(a_schedule) }
+			template <typename... TArgs>
+			explicit basic_thread_worker(thread_options a_options, TArgs&&... a_args)
+				: m_options{ std::move(a_options) }
+				, m_lane{ std::forward<TArgs>(a_args)... }
 			{
 				m_thread = std::thread{ &basic_thread_worker::start, this };
 			}
 
 			~basic_thread_worker()
 			{
-				set_pending_query(Query::Stop);
+				{
+					std::lock_guard<std::mutex> t_lock{ m_mutex };
+					m_isStopping = true;
+				}
+				m_sync.notify_all();
 				m_thread.join();
 			}
 
 			// Methods
+			/// @brief Requests this thread to execute its lane for a frame, once done with the frames already
+			/// requested. Frames it is not requested are skipped.
+			void request_execute(std::size_t const a_frame)
+			{
+				{
+					std::lock_guard<std::mutex> t_lock{ m_mutex };
+					assert(a_frame >= m_requestedFrameCount);
+					if (m_doneFrameCount == m_requestedFrameCount)
+					{
+						m_doneFrameCount = a_frame;
+					}
+					assert(m_doneFrameCount == a_frame || m_requestedFrameCount == a_frame);
+					m_requestedFrameCount = a_frame + 1;
+				}
+				m_sync.notify_all();
+			}
+
 			void request_execute()
 			{
-				set_pending_query(Query::Execute);
+				request_execute(m_requestedFrameCount);
 			}
 
+			/// @brief Requests this thread to execute a task once instead of its lane.
+			void request_execute(basic_task const& a_task)
+			{
+				{
+					std::lock_guard<std::mutex> t_lock{ m_mutex };
+					m_task = &a_task;
+				}
+				m_sync.notify_all();
+			}
+
+			/// @brief Waits for this thread to be done with all it was requested.
 			void wait_until_done()
 			{
 				std::unique_lock<std::mutex> t_lock{ m_mutex };
 				m_sync.wait(t_lock, [this]
 					{
-						return m_pendingQuery == Query::None;
+						return m_doneFrameCount == m_requestedFrameCount && m_task == nullptr;
 					});
 			}
 
+			/// @brief Waits for this thread to be done with the frames before a given one.
+			void wait_until_done(std::size_t const a_frameCount)
+			{
+				std::unique_lock<std::mutex> t_lock{ m_mutex };
+				m_sync.wait(t_lock, [this, a_frameCount]
+					{
+						return is_done_locked(a_frameCount);
+					});
+			}
+
+			[[nodiscard]] bool is_done(std::size_t const a_frameCount)
+			{
+				std::lock_guard<std::mutex> t_lock{ m_mutex };
+				return is_done_locked(a_frameCount);
+			}
+
+			/// @brief Provides access to the lane of this thread. Must not be called while it is executing.
+			TLane& get_lane()
+			{
+				return m_lane;
+			}
+
 			// Operators
 			basic_thread_worker& operator=(basic_thread_worker&&) = delete;
 			basic_thread_worker& operator=(basic_thread_worker const&) = delete;
 
 		private:
-			// Types
-			enum class Query
-			{
-				None,
-				Execute,
-				Stop
-			};
-
 			// Attributes
-			Query m_pendingQuery = Query::None;
+			std::size_t m_requestedFrameCount = 0;
+			std::size_t m_doneFrameCount = 0;
+			basic_task const* m_task = nullptr;
+			bool m_isStopping = false;
 			std::mutex m_mutex;
 			std::condition_variable m_sync;
 			std::thread m_thread;
 
-			task_span const& m_tasks;
-			basic_task_state_list<TTaskStateAllocator>& m_taskStates;
-			basic_thread_schedule<TScheduleAllocator> m_schedule;
+			thread_options m_options;
+			TLane m_lane;
 
 			// Methods
 			void start()
 			{
-				auto query = Query::None;
-				while (query != Query::Stop)
+				// Options are best effort: a thread that could not be pinned or named still executes its lane
+				apply_to_current_thread(m_options);
+
+				std::unique_lock<std::mutex> t_lock{ m_mutex };
+				while (true)
 				{
-					query = wait_for_query();
-					if (query == Query::Execute)
+					m_sync.wait(t_lock, [this]
+						{
+							return m_isStopping || m_task != nullptr || m_doneFrameCount < m_requestedFrameCount;
+						});
+					if (m_task != nullptr)
 					{
-						detail::execute_thread_schedule(m_schedule, m_tasks, m_taskStates);
-						set_pending_query(Query::None);
+						auto const task = m_task;
+						t_lock.unlock();
+						task->execute();
+						t_lock.lock();
+						m_task = nullptr;
 					}
+					else if (m_doneFrameCount < m_requestedFrameCount)
+					{
+						auto const frame = m_doneFrameCount;
+						t_lock.unlock();
+						m_lane.execute(frame);
+						t_lock.lock();
+						++m_doneFrameCount;
+					}
+					else
+					{
+						return;
+					}
+					m_sync.notify_all();
 				}
 			}
 
-			void set_pending_query(Query a_query)
-			{
-				{
-					std::lock_guard<std::mutex> t_lock{ m_mutex };
-					m_pendingQuery = a_query;
-				}
-				m_sync.notify_all();
-			}
-
-			Query wait_for_query()
+			bool is_done_locked(std::size_t const a_frameCount) const
 			{
-				std::unique_lock<std::mutex> t_lock{ m_mutex };
-				m_sync.wait(t_lock, [this]
-					{
-						return m_pendingQuery != Query::None;
-					});
-				return m_pendingQuery;
+				return m_doneFrameCount >= a_frameCount || m_doneFrameCount == m_requestedFrameCount;
 			}
 		};
 	}
 
-	template <typename TScheduleAllocator, typename TAllocator>
+	/// @brief A worker executing tasks on persistent threads, each following its part of a static schedule.
+	/// Tasks are either a task_span of basic_task or a basic_task_table, which must outlive the worker.
+	template <typename TScheduleAllocator, typename TAllocator, typename TTasks = task_span>
 	class basic_worker
 	{
 		// TYpes
 		using task_state_allocator =
-			typename std::allocator_traits<TAllocator>::template rebind_alloc<std::shared_ptr<detail::task_state>>;
+			typename std::allocator_traits<TAllocator>::template rebind_alloc<detail::task_state>;
 		using task_state_list = detail::basic_task_state_list<task_state_allocator>;
-		using thread_worker = detail::basic_thread_worker<TScheduleAllocator, task_state_allocator>;
+		using dependency_table = detail::basic_dependency_table<TAllocator>;
+#if VOB_MISMT_TRACE
+		using trace_type = basic_trace<TAllocator>;
+#else
+		using trace_type = detail::basic_disabled_trace<TAllocator>;
+#endif
+		using frame_list = detail::basic_frame_list<task_state_allocator>;
+		using task_record_list = detail::basic_task_record_list<task_state_allocator>;
+		using thread_worker = detail::basic_thread_worker<
+			detail::basic_schedule_lane<TScheduleAllocator, TAllocator, task_state_allocator, TAllocator, TTasks>>;
 		using thread_worker_allocator =
 			typename std::allocator_traits<TAllocator>::template rebind_alloc<std::shared_ptr<thread_worker>>;
 		using thread_worker_list = std::vector<std::shared_ptr<thread_worker>, thread_worker_allocator>;
@@ -209,51 +619,248 @@ namespace vob::mismt
 		using schedule = basic_schedule<TScheduleAllocator>;
 		using thread_schedule = basic_thread_schedule<TScheduleAllocator>;
 
+		/// @brief Identifies an execution started by submit, to wait for it.
+		class execution_handle
+		{
+		public:
+			// Constructors
+			explicit execution_handle(std::size_t const a_frame)
+				: m_frame{ a_frame }
+			{}
+
+			// Methods
+			[[nodiscard]] std::size_t get_frame() const
+			{
+				return m_frame;
+			}
+
+		private:
+			// Attributes
+			std::size_t m_frame;
+		};
+
 		// Constructors
-		basic_worker(basic_worker&&) = default;
+		basic_worker(basic_worker&&) = delete;
 
 		basic_worker(basic_worker const&) = delete;
 
-		basic_worker(task_span const& a_tasks, schedule a_schedule)
-			: m_tasks{ a_tasks }
+		/// @brief Creates a worker with a thread per lane of a schedule, the first lane being executed by the thread
+		/// calling execute, or by an additional thread for submitted executions.
+		/// Thread options apply to the lane with the same index, those of the first lane to the calling thread.
+		basic_worker(
+			TTasks const& a_tasks,
+			schedule a_schedule,
+			std::span<thread_options const> const a_threadOptions = {},
+			TAllocator const& a_allocator = {})
+			: m_threadWorkers{ thread_worker_allocator{ a_allocator } }
+			, m_tasks{ a_tasks }
+			, m_dependencies{ a_tasks.size(), a_schedule, a_allocator }
+			, m_trace{ a_schedule.size(), a_allocator }
+			, m_frames{
+				detail::basic_frame<task_state_allocator>{
+					task_state_list(a_tasks.size(), task_state_allocator{ a_allocator }) },
+				detail::basic_frame<task_state_allocator>{
+					task_state_list(a_tasks.size(), task_state_allocator{ a_allocator }) } }
+			, m_taskRecords(a_tasks.size(), typename task_record_list::allocator_type{ a_allocator })
 			, m_mainThreadSchedule{ std::move(a_schedule.front()) }
 		{
 			assert(!a_schedule.empty());
-
-			m_taskStates.resize(a_tasks.size());
-			for (auto& taskState : m_taskStates)
+			if (!a_threadOptions.empty())
 			{
-				taskState = std::allocate_shared<detail::task_state>(m_taskStates.get_allocator());
+				m_mainThreadOptions = a_threadOptions.front();
+				apply_to_current_thread(m_mainThreadOptions);
 			}
 
 			m_threadWorkers.reserve(a_schedule.size() - 1);
 			auto t_it = a_schedule.begin();
 			while (++t_it != a_schedule.end())
 			{
+				auto const lane = static_cast<std::size_t>(t_it - a_schedule.begin());
 				m_threadWorkers.emplace_back(std::allocate_shared<thread_worker>(
-					m_threadWorkers.get_allocator(), a_tasks, m_taskStates, *t_it));
+					m_threadWorkers.get_allocator(),
+					lane < a_threadOptions.size() ? a_threadOptions[lane] : thread_options{},
+					a_tasks,
+					m_dependencies,
+					m_frames,
+					m_taskRecords,
+					m_trace.get_lane(lane),
+					*t_it));
 			}
 		}
 
-		~basic_worker() = default;
+		~basic_worker()
+		{
+			wait();
+		}
 
 		// Methods
-		void execute()
+		/// @brief Executes the scheduled tasks and waits for them to be done, the calling thread executing the first
+		/// lane. Executions submitted before are waited for first.
+		/// An incremental execution skips the subgraphs whose inputs did not change since they last executed, see
+		/// basic_task::get_input_version.
+		void execute(execution_mode const a_mode = execution_mode::Full)
+		{
+			wait();
+			auto const frame = start_frame(a_mode);
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->request_execute(frame);
+			}
+			auto& mainFrame = m_frames[frame % m_frames.size()];
+			detail::execute_thread_schedule(
+				m_mainThreadSchedule,
+				m_tasks,
+				m_dependencies,
+				mainFrame.m_taskStates,
+				m_taskRecords,
+				m_trace.get_lane(0),
+				mainFrame.m_mode);
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->wait_until_done(frame + 1);
+			}
+		}
+
+		/// @brief Starts executing the scheduled tasks without waiting for them, the first lane being executed by an
+		/// additional thread.
+		/// Each thread starts the next execution as soon as it is done with its part of the previous one, so the
+		/// first tasks of an execution overlap with the last tasks of the previous one. A task never overlaps with
+		/// itself, but it may overlap with tasks of the previous execution reading what it writes: such data must be
+		/// double-buffered. At most two executions are in flight: submitting a third one waits for the first one.
+		execution_handle submit(execution_mode const a_mode = execution_mode::Full)
 		{
-			reset_task_states();
+			if (m_frameCount >= m_frames.size())
+			{
+				wait_for_frames(m_frameCount - m_frames.size() + 1);
+			}
+			if (m_mainThreadWorker == nullptr)
+			{
+				m_mainThreadWorker = std::allocate_shared<thread_worker>(
+					m_threadWorkers.get_allocator(),
+					m_mainThreadOptions,
+					m_tasks,
+					m_dependencies,
+					m_frames,
+					m_taskRecords,
+					m_trace.get_lane(0),
+					m_mainThreadSchedule);
+			}
+
+			auto const frame = start_frame(a_mode);
+			m_mainThreadWorker->request_execute(frame);
 			for (auto& threadWorker : m_threadWorkers)
 			{
-				threadWorker->request_execute();
+				threadWorker->request_execute(frame);
 			}
-			execute_main_thread_schedule();
+			return execution_handle{ frame };
+		}
+
+		/// @brief Waits for a submitted execution to be done.
+		void wait(execution_handle const& a_handle)
+		{
+			wait_for_frames(a_handle.get_frame() + 1);
+		}
+
+		/// @brief Waits for all submitted executions to be done.
+		void wait()
+		{
+			wait_for_frames(m_frameCount);
+		}
+
+		[[nodiscard]] bool is_done(execution_handle const& a_handle) const
+		{
+			auto const frameCount = a_handle.get_frame() + 1;
+			return (m_mainThreadWorker == nullptr || m_mainThreadWorker->is_done(frameCount))
+				&& std::all_of(
+					m_threadWorkers.begin(),
+					m_threadWorkers.end(),
+					[frameCount](auto const& a_threadWorker)
+					{
+						return a_threadWorker->is_done(frameCount);
+					});
+		}
+
+		/// @brief Provides the number of threads executing tasks, including the one calling execute.
+		[[nodiscard]] std::size_t get_thread_count() const
+		{
+			return m_threadWorkers.size() + 1;
+		}
+
+		/// @brief Executes a task once on each thread of this worker, including the calling one, and waits for all
+		/// of them to be done. Must not be called during an execution.
+		void execute_on_all_threads(basic_task const& a_task)
+		{
+			wait();
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->request_execute(a_task);
+			}
+			a_task.execute();
 			for (auto& threadWorker : m_threadWorkers)
 			{
 				threadWorker->wait_until_done();
 			}
 		}
 
+		/// @brief Provides how long a task took during the last execution, once it is done.
+		[[nodiscard]] std::chrono::nanoseconds get_task_duration(task_id const a_id) const
+		{
+			return m_taskRecords[a_id].get_duration();
+		}
+
+		/// @brief Whether a task was skipped by the last execution, because it is not scheduled or because its inputs
+		/// did not change during an incremental execution. A skipped task keeps its last measured duration.
+		[[nodiscard]] bool was_task_skipped(task_id const a_id) const
+		{
+			return !get_last_frame().m_taskStates[a_id].was_executed();
+		}
+
+		/// @brief Forces every task to execute during the next incremental execution.
+		/// Must not be called while an execution is in flight.
+		void invalidate()
+		{
+			for (auto& taskRecord : m_taskRecords)
+			{
+				taskRecord.invalidate();
+			}
+		}
+
+		/// @brief Replaces the schedule of this worker by another one with as many threads, for instance one
+		/// rebalanced with the durations measured during previous executions. Waits for submitted executions first.
+		/// As dependencies may have changed, every task executes during the next incremental execution.
+		void set_schedule(schedule a_schedule)
+		{
+			assert(a_schedule.size() == m_threadWorkers.size() + 1);
+			wait();
+			invalidate();
+			m_dependencies = dependency_table{ m_tasks.size(), a_schedule, m_dependencies.get_allocator() };
+			m_mainThreadSchedule = std::move(a_schedule.front());
+			if (m_mainThreadWorker != nullptr)
+			{
+				m_mainThreadWorker->get_lane().set_schedule(m_mainThreadSchedule);
+			}
+			for (auto i = 0u; i < m_threadWorkers.size(); ++i)
+			{
+				m_threadWorkers[i]->get_lane().set_schedule(std::move(a_schedule[i + 1]));
+			}
+		}
+
+#if VOB_MISMT_TRACE
+		/// @brief Provides the task events recorded by each thread since the trace was last cleared.
+		[[nodiscard]] trace_type const& get_trace() const
+		{
+			return m_trace;
+		}
+
+		/// @brief Provides the task events recorded by each thread since the trace was last cleared.
+		[[nodiscard]] trace_type& get_trace()
+		{
+			return m_trace;
+		}
+#endif
+
 		// Operators
-		basic_worker& operator=(basic_worker&&) = default;
+		basic_worker& operator=(basic_worker&&) = delete;
 
 		basic_worker& operator=(basic_worker const&) = delete;
 
@@ -261,28 +868,53 @@ namespace vob::mismt
 		// Attributes
 
 		thread_worker_list m_threadWorkers;
-		task_span const& m_tasks;
+		TTasks const& m_tasks;
+		dependency_table m_dependencies;
+		trace_type m_trace;
 		
-		task_state_list m_taskStates;
+		frame_list m_frames;
+		std::size_t m_frameCount = 0;
+		task_record_list m_taskRecords;
 		thread_schedule m_mainThreadSchedule;
+		thread_options m_mainThreadOptions;
+		std::shared_ptr<thread_worker> m_mainThreadWorker;
 
 		// Methods
-		void reset_task_states()
+		/// @brief Prepares the states of the next frame, which the frame using them before must be done with.
+		std::size_t start_frame(execution_mode const a_mode)
 		{
-			for (auto& taskState : m_taskStates)
+			auto& frame = m_frames[m_frameCount % m_frames.size()];
+			frame.m_mode = a_mode;
+			for (auto i = 0u; i < frame.m_taskStates.size(); ++i)
 			{
-				taskState->set_is_done(false);
+				frame.m_taskStates[i].reset(m_dependencies.get_predecessor_count(i));
 			}
+			return m_frameCount++;
 		}
 
-		void execute_main_thread_schedule()
+		void wait_for_frames(std::size_t const a_frameCount)
 		{
-			detail::execute_thread_schedule(m_mainThreadSchedule, m_tasks, m_taskStates);
+			if (m_mainThreadWorker != nullptr)
+			{
+				m_mainThreadWorker->wait_until_done(a_frameCount);
+			}
+			for (auto& threadWorker : m_threadWorkers)
+			{
+				threadWorker->wait_until_done(a_frameCount);
+			}
+		}
+
+		[[nodiscard]] detail::basic_frame<task_state_allocator> const& get_last_frame() const
+		{
+			return m_frames[(m_frameCount + m_frames.size() - 1) % m_frames.size()];
 		}
 	};
 
 	using worker = basic_worker<std::allocator<task_id>, std::allocator<void>>;
 
+	/// @brief A worker executing the tasks of a task table, for tasks so small that dispatch overhead matters.
+	using task_table_worker = basic_worker<std::allocator<task_id>, std::allocator<void>, task_table>;
+
 	namespace pmr
 	{
 		using task_description = basic_task_description<std::pmr::polymorphic_allocator<task_id>>;
@@ -295,6 +927,12 @@ namespace vob::mismt
 			std::pmr::polymorphic_allocator<task_id>,
 			std::pmr::polymorphic_allocator<void>
 		>;
+
+		using task_table_worker = basic_worker<
+			std::pmr::polymorphic_allocator<task_id>,
+			std::pmr::polymorphic_allocator<void>,
+			pmr::task_table
+		>;
 	}
 }
 
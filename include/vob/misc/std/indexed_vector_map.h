@@ -0,0 +1,263 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <utility>
+#include <vector>
+
+
+namespace vob::mistd
+{
+	namespace detail
+	{
+		/// @brief Open addressing table of entry indices, with 0 for empty slots and index + 1 otherwise.
+		/// Its size is a power of two, at least twice the number of entries.
+		struct index_table
+		{
+			/// @brief Provides the table size for a number of entries.
+			static std::size_t get_capacity(std::size_t const a_entryCount)
+			{
+				return std::bit_ceil(2 * a_entryCount);
+			}
+
+			/// @brief Finds the index of the entry matching a hash and predicate, or returns a_notFound.
+			/// The table is anything with a size and an indexing operator providing slots, such as a vector.
+			template <typename TTable, typename TIsMatch>
+			static std::size_t find(
+				TTable const& a_table,
+				std::size_t const a_hash,
+				std::size_t const a_notFound,
+				TIsMatch&& a_isMatch)
+			{
+				auto const mask = a_table.size() - 1;
+				for (auto slot = a_hash & mask; a_table[slot] != 0; slot = (slot + 1) & mask)
+				{
+					auto const index = a_table[slot] - 1;
+					if (a_isMatch(index))
+					{
+						return index;
+					}
+				}
+				return a_notFound;
+			}
+
+			/// @brief Inserts an entry index, which must not already be in the table.
+			static void insert(std::span<std::uint32_t> const a_table, std::size_t const a_hash, std::size_t a_index)
+			{
+				auto const mask = a_table.size() - 1;
+				auto slot = a_hash & mask;
+				while (a_table[slot] != 0)
+				{
+					slot = (slot + 1) & mask;
+				}
+				a_table[slot] = static_cast<std::uint32_t>(a_index + 1);
+			}
+		};
+	}
+
+	/// @brief A vector_map that indexes its keys in a hash table once it holds t_indexThreshold entries, so lookups
+	/// stay constant time for large maps while small ones keep a linear search over contiguous entries.
+	/// Entries are iterated in insertion order.
+	template <
+		typename TKey,
+		typename TValue,
+		typename THash = std::hash<TKey>,
+		typename TKeyEqual = std::equal_to<>,
+		typename TAllocator = std::allocator<std::pair<TKey const, TValue>>,
+		std::size_t t_indexThreshold = 16>
+	class indexed_vector_map
+	{
+	public:
+#pragma region TYPES
+		using key_type = TKey;
+		using value_type = TValue;
+#pragma endregion
+
+#pragma region CREATORS
+		/// @brief Creates an empty map.
+		indexed_vector_map() = default;
+
+		/// @brief Creates an empty map using the given allocator.
+		explicit indexed_vector_map(TAllocator const& a_allocator)
+			: m_data{ a_allocator }
+			, m_index{ index_allocator{ a_allocator } }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		[[nodiscard]] auto empty() const
+		{
+			return m_data.empty();
+		}
+
+		[[nodiscard]] auto size() const
+		{
+			return m_data.size();
+		}
+
+		[[nodiscard]] auto begin() const
+		{
+			return m_data.begin();
+		}
+
+		[[nodiscard]] auto end() const
+		{
+			return m_data.end();
+		}
+
+		/// @brief Finds the entry of a key, or end.
+		[[nodiscard]] auto find(TKey const& a_key) const
+		{
+			return begin() + find_index(a_key);
+		}
+
+		/// @brief Finds the entry of a key whose hash is already known, which must be THash{}(a_key), or end.
+		[[nodiscard]] auto find(TKey const& a_key, std::size_t const a_hash) const
+		{
+			return begin() + find_index(a_key, [a_hash]() { return a_hash; });
+		}
+
+		[[nodiscard]] auto const& operator[](TKey const& a_key) const
+		{
+			return find(a_key)->second;
+		}
+
+		[[nodiscard]] constexpr auto get_allocator() const
+		{
+			return m_data.get_allocator();
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Adds an entry if its key is not in the map yet, see std::map::emplace.
+		decltype(auto) emplace(std::pair<TKey const, TValue>&& a_entry)
+		{
+			auto const index = find_index(a_entry.first);
+			if (index != m_data.size())
+			{
+				return std::make_pair(begin() + index, false);
+			}
+
+			m_data.emplace_back(std::move(a_entry));
+			if (!m_index.empty() && index_table::get_capacity(m_data.size()) == m_index.size())
+			{
+				index_table::insert(m_index, THash{}(m_data.back().first), index);
+			}
+			else if (m_data.size() >= t_indexThreshold)
+			{
+				rebuild_index();
+			}
+			return std::make_pair(--end(), true);
+		}
+
+		/// @brief Adds an entry if its key is not in the map yet.
+		decltype(auto) emplace(TKey a_key, TValue a_value = {})
+		{
+			return emplace(std::make_pair(std::move(a_key), std::move(a_value)));
+		}
+
+		void reserve(std::size_t const a_capacity)
+		{
+			m_data.reserve(a_capacity);
+		}
+
+		auto begin()
+		{
+			return m_data.begin();
+		}
+
+		auto end()
+		{
+			return m_data.end();
+		}
+
+		/// @brief Finds the entry of a key, or end.
+		auto find(TKey const& a_key)
+		{
+			return begin() + find_index(a_key);
+		}
+
+		/// @brief Finds the entry of a key whose hash is already known, which must be THash{}(a_key), or end.
+		auto find(TKey const& a_key, std::size_t const a_hash)
+		{
+			return begin() + find_index(a_key, [a_hash]() { return a_hash; });
+		}
+
+		auto& operator[](TKey const& a_key)
+		{
+			return find(a_key)->second;
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_TYPES
+		using index_table = detail::index_table;
+		using index_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<std::uint32_t>;
+#pragma endregion
+
+#pragma region PRIVATE_DATA
+		std::vector<std::pair<TKey const, TValue>, TAllocator> m_data;
+		/// @brief Empty until the map reaches t_indexThreshold entries.
+		std::vector<std::uint32_t, index_allocator> m_index;
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+		[[nodiscard]] std::size_t find_index(TKey const& a_key) const
+		{
+			return find_index(a_key, [&a_key]() { return THash{}(a_key); });
+		}
+
+		/// @brief Finds the index of a key, or size, a_getHash being only called if the map is indexed.
+		template <typename TGetHash>
+		[[nodiscard]] std::size_t find_index(TKey const& a_key, TGetHash&& a_getHash) const
+		{
+			auto const isMatch = [this, &a_key](std::size_t const a_index)
+			{
+				return TKeyEqual{}(m_data[a_index].first, a_key);
+			};
+
+			if (m_index.empty())
+			{
+				auto index = std::size_t{ 0 };
+				while (index != m_data.size() && !isMatch(index))
+				{
+					++index;
+				}
+				return index;
+			}
+			return index_table::find(m_index, a_getHash(), m_data.size(), isMatch);
+		}
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		void rebuild_index()
+		{
+			m_index.assign(index_table::get_capacity(m_data.size()), 0);
+			for (auto index = std::size_t{ 0 }; index < m_data.size(); ++index)
+			{
+				index_table::insert(m_index, THash{}(m_data[index].first), index);
+			}
+		}
+#pragma endregion
+	};
+
+	namespace pmr
+	{
+		template <
+			typename TKey,
+			typename TValue,
+			typename THash = std::hash<TKey>,
+			typename TKeyEqual = std::equal_to<>>
+		using indexed_vector_map = mistd::indexed_vector_map<
+			TKey,
+			TValue,
+			THash,
+			TKeyEqual,
+			std::pmr::polymorphic_allocator<std::pair<TKey const, TValue>>>;
+	}
+}
@@ -1,14 +1,25 @@
 #pragma once
 
-#include "../std/string_vector_map.h"
+#include "../hash/fnv1a.h"
+#include "../std/json_number_parser.h"
+#include "../std/string_indexed_vector_map.h"
 #include "../std/polymorphic_ptr.h"
 #include "../std/polymorphic_ptr_util.h"
 
+#include <array>
 #include <iomanip>
+#include <memory_resource>
 #include <variant>
 #include <vector>
 #include <string>
 #include <string_view>
+#include <type_traits>
+
+/// @brief Whether JSON numbers with a fraction or exponent are stored as double rather than long double.
+/// Doubles are converted faster, and long double adds no precision on platforms where both types are the same.
+#ifndef VOB_MISTD_JSON_DOUBLE
+#define VOB_MISTD_JSON_DOUBLE 0
+#endif
 
 namespace vob::mistd
 {
@@ -98,6 +109,10 @@ namespace vob::mistd
 	struct basic_json_number
 		: public detail::basic_json_value_base<TAllocator>
 	{
+#pragma region TYPES
+		using floating_type = std::conditional_t<VOB_MISTD_JSON_DOUBLE, double, long double>;
+#pragma endregion
+
 #pragma region CLASS_DATA
 		constexpr static auto type = json_value_type::number;
 #pragma endregion
@@ -121,14 +136,14 @@ namespace vob::mistd
 		{}
 
 		/// @brief TODO
-		basic_json_number(long double a_value)
+		basic_json_number(floating_type a_value)
 			: detail::basic_json_value_base<TAllocator>{ type }
 			, value{ a_value }
 		{}
 #pragma endregion
 
 #pragma region DATA
-		std::variant<std::int64_t, std::uint64_t, long double> value;
+		std::variant<std::int64_t, std::uint64_t, floating_type> value;
 #pragma endregion
 	};
 
@@ -180,6 +195,7 @@ namespace vob::mistd
 #pragma endregion
 	};
 
+	/// @brief Keys are hashed with mishs::fnv1a, so members can be looked up with hashes computed at compile time.
 	template <typename TAllocator = std::allocator<char>>
 	struct basic_json_object
 		: public detail::basic_json_value_base<TAllocator>
@@ -205,10 +221,11 @@ namespace vob::mistd
 #pragma endregion
 
 #pragma region DATA
-		string_vector_map<
+		string_indexed_vector_map<
 			value_type,
 			string_type,
 			std::string_view,
+			basic_string_map_key_hash<string_type, std::string_view, mishs::fnv1a_hash>,
 			std::equal_to<>,
 			allocator_type> data;
 #pragma endregion
@@ -320,38 +337,38 @@ namespace vob::mistd
 		{
 		case '"':
 		{
-			auto& string = a_value.set<basic_json_string<TAllocator>>(a_value.get_allocator());
+			auto& string = a_value.template set<basic_json_string<TAllocator>>(a_value.get_allocator());
 			a_inputStream >> string;
 			break;
 		}
 		case '{':
 		{
-			auto& object = a_value.set<basic_json_object<TAllocator>>(a_value.get_allocator());
+			auto& object = a_value.template set<basic_json_object<TAllocator>>(a_value.get_allocator());
 			a_inputStream >> object;
 			break;
 		}
 		case '[':
 		{
-			auto& array = a_value.set<basic_json_array<TAllocator>>(a_value.get_allocator());
+			auto& array = a_value.template set<basic_json_array<TAllocator>>(a_value.get_allocator());
 			a_inputStream >> array;
 			break;
 		}
 		case 't':
 		case 'f':
 		{
-			auto& boolean = a_value.set<basic_json_boolean<TAllocator>>();
+			auto& boolean = a_value.template set<basic_json_boolean<TAllocator>>();
 			a_inputStream >> boolean;
 			break;
 		}
 		case 'n':
 		{
-			auto& null = a_value.set<basic_json_null<TAllocator>>();
+			auto& null = a_value.template set<basic_json_null<TAllocator>>();
 			a_inputStream >> null;
 			break;
 		}
 		default:
 		{
-			auto& number = a_value.set<basic_json_number<TAllocator>>();
+			auto& number = a_value.template set<basic_json_number<TAllocator>>();
 			a_inputStream >> number;
 			break;
 		}
@@ -544,6 +561,11 @@ namespace vob::mistd
 				a_inputStream.setstate(std::ios_base::failbit);
 				return false;
 			}
+			// Peeking past the end would set failbit on a valid number
+			if (a_inputStream.eof())
+			{
+				return false;
+			}
 			char const c = a_inputStream.peek();
 			if (c >= a_min && c <= a_max)
 			{
@@ -558,7 +580,7 @@ namespace vob::mistd
 			return tryReadRange(a_value, a_value);
 		};
 
-		auto const isNegative = tryRead('-');
+		tryRead('-');
 		if (!tryRead('0'))
 		{
 			if (!tryReadRange('1', '9'))
@@ -569,8 +591,7 @@ namespace vob::mistd
 			while (tryReadRange('0', '9')) {}
 		}
 
-		auto const isFloat = tryRead('.');
-		if (isFloat)
+		if (tryRead('.'))
 		{
 			if (!tryReadRange('0', '9'))
 			{
@@ -578,36 +599,27 @@ namespace vob::mistd
 				return a_inputStream;
 			}
 			while (tryReadRange('0', '9')) {}
+		}
 
-			if (tryRead('e') || tryRead('E'))
+		if (tryRead('e') || tryRead('E'))
+		{
+			if (!tryRead('+'))
+			{
+				tryRead('-');
+			}
+			if (!tryReadRange('0', '9'))
 			{
-				if (!tryRead('+'))
-				{
-					tryRead('-');
-				}
-				if (!tryReadRange('0', '9'))
-				{
-					a_inputStream.setstate(std::ios_base::failbit);
-				}
-				while (tryReadRange('0', '9')) {}
+				a_inputStream.setstate(std::ios_base::failbit);
+				return a_inputStream;
 			}
+			while (tryReadRange('0', '9')) {}
 		}
-		representation[index] = 0;
 
-		if (isFloat)
+		char const* current = representation.data();
+		if (!detail::parse_json_number(current, current + index, a_number.value)
+			|| current != representation.data() + index)
 		{
-			char* end;
-			a_number.value = std::strtold(representation.data(), &end);
-		}
-		else if (isNegative)
-		{
-			char* end;
-			a_number.value = std::strtoll(representation.data(), &end, 10);
-		}
-		else
-		{
-			char* end;
-			a_number.value = std::strtoull(representation.data(), &end, 10);
+			a_inputStream.setstate(std::ios_base::failbit);
 		}
 		return a_inputStream;
 	}
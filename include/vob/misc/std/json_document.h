@@ -0,0 +1,937 @@
+#pragma once
+
+#include "../hash/fnv1a.h"
+
+#include "json.h"
+#include "json_parser.h"
+#include "indexed_vector_map.h"
+#include "json_structural_index.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <variant>
+#include <vector>
+
+
+namespace vob::mistd
+{
+	class json_node;
+
+	namespace detail
+	{
+		template <typename TAllocator>
+		class basic_json_document_builder;
+
+		/// @brief The hash table of an object's keys, stored in the document's nodes after its members. Slots are
+		/// copied out of the nodes' bytes, as the nodes hold no std::uint32_t objects to read them through.
+		struct json_key_table
+		{
+			std::byte const* m_slots;
+			std::size_t m_size;
+
+			[[nodiscard]] std::size_t size() const
+			{
+				return m_size;
+			}
+
+			[[nodiscard]] std::uint32_t operator[](std::size_t const a_slot) const
+			{
+				std::uint32_t slot;
+				std::memcpy(&slot, m_slots + a_slot * sizeof(slot), sizeof(slot));
+				return slot;
+			}
+		};
+	}
+
+	/// @brief How a document stores the strings of its source.
+	enum class json_string_mode
+	{
+		/// @brief Strings are copied into the document, which is independent from its source.
+		copy,
+		/// @brief Strings without escape sequences point into the source, which must outlive the document. Only
+		/// strings with escape sequences are decoded into the document.
+		reference
+	};
+
+	/// @brief Read view of a null node.
+	struct json_node_null
+	{
+#pragma region CLASS_DATA
+		constexpr static auto type = json_value_type::null;
+#pragma endregion
+	};
+
+	/// @brief Read view of a boolean node.
+	struct json_node_boolean
+	{
+#pragma region CLASS_DATA
+		constexpr static auto type = json_value_type::boolean;
+#pragma endregion
+
+#pragma region DATA
+		bool value;
+#pragma endregion
+	};
+
+	/// @brief Read view of a number node. Fractions are stored as double to fit a node.
+	struct json_node_number
+	{
+#pragma region CLASS_DATA
+		constexpr static auto type = json_value_type::number;
+#pragma endregion
+
+#pragma region DATA
+		std::variant<std::int64_t, std::uint64_t, double> value;
+#pragma endregion
+	};
+
+	/// @brief Read view of a string node, pointing into its document.
+	struct json_node_string
+	{
+#pragma region CLASS_DATA
+		constexpr static auto type = json_value_type::string;
+#pragma endregion
+
+#pragma region DATA
+		std::string_view value;
+#pragma endregion
+	};
+
+	/// @brief Read view of an array node, whose elements are contiguous in its document.
+	struct json_node_array
+	{
+#pragma region CLASS_DATA
+		constexpr static auto type = json_value_type::array;
+#pragma endregion
+
+#pragma region DATA
+		std::span<json_node const> data;
+#pragma endregion
+	};
+
+	/// @brief A member of an object node, named like std::pair so that map-like code can read it.
+	struct json_node_member
+	{
+		std::string_view first;
+		json_node const& second;
+	};
+
+	/// @brief Read view of the members of an object node, stored as contiguous key and value nodes.
+	/// Objects with many members are followed by a hash table of their keys, hashed with mishs::fnv1a, see
+	/// detail::index_table.
+	class json_node_members
+	{
+	public:
+#pragma region CLASS_DATA
+		/// @brief Number of members from which an object has a hash table.
+		constexpr static std::size_t index_threshold = 16;
+#pragma endregion
+
+#pragma region TYPES
+		class iterator
+		{
+			/// @brief Members are built on the fly, so operator-> returns them through this.
+			struct arrow_proxy
+			{
+				json_node_member m_member;
+
+				json_node_member const* operator->() const
+				{
+					return &m_member;
+				}
+			};
+
+		public:
+			using value_type = json_node_member;
+			using difference_type = std::ptrdiff_t;
+
+			iterator() = default;
+
+			explicit iterator(json_node const* a_key)
+				: m_key{ a_key }
+			{}
+
+			json_node_member operator*() const;
+
+			arrow_proxy operator->() const
+			{
+				return { **this };
+			}
+
+			iterator& operator++();
+
+			iterator operator++(int)
+			{
+				auto const previous = *this;
+				++*this;
+				return previous;
+			}
+
+			bool operator==(iterator const&) const = default;
+
+		private:
+			json_node const* m_key = nullptr;
+		};
+#pragma endregion
+
+#pragma region CREATORS
+		json_node_members(json_node const* a_first, std::size_t a_size)
+			: m_first{ a_first }
+			, m_size{ a_size }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		[[nodiscard]] iterator begin() const
+		{
+			return iterator{ m_first };
+		}
+
+		[[nodiscard]] iterator end() const;
+
+		[[nodiscard]] std::size_t size() const
+		{
+			return m_size;
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return m_size == 0;
+		}
+
+		/// @brief Finds the first member with the given key, or end.
+		[[nodiscard]] iterator find(std::string_view a_key) const;
+
+		/// @brief Finds the first member with the given key, whose mishs::fnv1a hash is already known, or end.
+		[[nodiscard]] iterator find(std::string_view a_key, std::size_t a_hash) const;
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		json_node const* m_first;
+		std::size_t m_size;
+#pragma endregion
+	};
+
+	/// @brief Read view of an object node.
+	struct json_node_object
+	{
+#pragma region CLASS_DATA
+		constexpr static auto type = json_value_type::object;
+#pragma endregion
+
+#pragma region DATA
+		json_node_members data;
+#pragma endregion
+	};
+
+	/// @brief A value of a basic_json_document: a tagged 16 bytes node.
+	/// Scalars are stored inline. Strings and children are elsewhere in the same document, at an offset relative to
+	/// the node: documents can be moved or copied as a single buffer. Object children are alternating key and value
+	/// nodes.
+	/// Values are read with the same get<T>() as basic_json_value, but they are views returned by value.
+	class json_node
+	{
+	public:
+#pragma region TYPES
+		using null_type = json_node_null;
+		using boolean_type = json_node_boolean;
+		using number_type = json_node_number;
+		using string_type = json_node_string;
+		using array_type = json_node_array;
+		using object_type = json_node_object;
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Provides the type of the value.
+		[[nodiscard]] auto get_type() const
+		{
+			return m_type;
+		}
+
+		/// @brief Provides a view of the value if it has the given type.
+		template <typename TValueType>
+		[[nodiscard]] auto get() const -> std::optional<TValueType>
+		{
+			if (m_type != TValueType::type)
+			{
+				return std::nullopt;
+			}
+
+			if constexpr (std::is_same_v<TValueType, null_type>)
+			{
+				return null_type{};
+			}
+			else if constexpr (std::is_same_v<TValueType, boolean_type>)
+			{
+				return boolean_type{ m_boolean };
+			}
+			else if constexpr (std::is_same_v<TValueType, number_type>)
+			{
+				switch (static_cast<number_kind>(m_size))
+				{
+				case number_kind::signed_integer: return number_type{ m_signed };
+				case number_kind::unsigned_integer: return number_type{ m_unsigned };
+				default: return number_type{ m_floating };
+				}
+			}
+			else if constexpr (std::is_same_v<TValueType, string_type>)
+			{
+				if ((m_size & s_referenceBit) != 0)
+				{
+					return string_type{ { m_characters, m_size & ~s_referenceBit } };
+				}
+				return string_type{ { reinterpret_cast<char const*>(get_data()), m_size } };
+			}
+			else if constexpr (std::is_same_v<TValueType, array_type>)
+			{
+				return array_type{ { reinterpret_cast<json_node const*>(get_data()), m_size } };
+			}
+			else
+			{
+				return object_type{ { reinterpret_cast<json_node const*>(get_data()), m_size } };
+			}
+		}
+#pragma endregion
+
+	private:
+		template <typename TAllocator>
+		friend class detail::basic_json_document_builder;
+
+#pragma region PRIVATE_CLASS_DATA
+		/// @brief Set in the size of strings that point into the source rather than into the document.
+		constexpr static std::uint32_t s_referenceBit = std::uint32_t{ 1 } << 31;
+#pragma endregion
+
+#pragma region PRIVATE_TYPES
+		enum class number_kind : std::uint32_t
+		{
+			signed_integer,
+			unsigned_integer,
+			floating
+		};
+#pragma endregion
+
+#pragma region PRIVATE_DATA
+		union
+		{
+			bool m_boolean;
+			std::int64_t m_signed;
+			std::uint64_t m_unsigned;
+			double m_floating;
+			char const* m_characters;
+			/// @brief Distance in bytes from this node to its characters or children.
+			std::int64_t m_offset = 0;
+		};
+		/// @brief Characters of a string, elements of an array, members of an object or kind of a number.
+		std::uint32_t m_size = 0;
+		json_value_type m_type = json_value_type::null;
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+		[[nodiscard]] std::byte const* get_data() const
+		{
+			return reinterpret_cast<std::byte const*>(this) + m_offset;
+		}
+
+		/// @brief Whether the node has characters or children in its document, at m_offset.
+		[[nodiscard]] bool has_offset() const
+		{
+			switch (m_type)
+			{
+			case json_value_type::string:
+				return m_size != 0 && (m_size & s_referenceBit) == 0;
+			case json_value_type::array:
+			case json_value_type::object:
+				return m_size != 0;
+			default:
+				return false;
+			}
+		}
+#pragma endregion
+	};
+
+	static_assert(sizeof(json_node) == 16);
+
+	inline json_node_member json_node_members::iterator::operator*() const
+	{
+		return { m_key->get<json_node_string>()->value, m_key[1] };
+	}
+
+	inline json_node_members::iterator& json_node_members::iterator::operator++()
+	{
+		m_key += 2;
+		return *this;
+	}
+
+	inline json_node_members::iterator json_node_members::end() const
+	{
+		return iterator{ m_first + 2 * m_size };
+	}
+
+	inline json_node_members::iterator json_node_members::find(std::string_view const a_key) const
+	{
+		// Only objects with a hash table need the hash of the key
+		return find(a_key, m_size >= index_threshold ? mishs::fnv1a_hash{}(a_key) : 0);
+	}
+
+	inline json_node_members::iterator json_node_members::find(
+		std::string_view const a_key,
+		std::size_t const a_hash) const
+	{
+		if (m_size >= index_threshold)
+		{
+			detail::json_key_table const table{
+				reinterpret_cast<std::byte const*>(m_first + 2 * m_size),
+				detail::index_table::get_capacity(m_size) };
+			auto const index = detail::index_table::find(
+				table,
+				a_hash,
+				m_size,
+				[this, a_key](std::size_t const a_index)
+				{
+					return m_first[2 * a_index].get<json_node_string>()->value == a_key;
+				});
+			return iterator{ m_first + 2 * index };
+		}
+
+		auto it = begin();
+		for (auto const last = end(); it != last; ++it)
+		{
+			if (it->first == a_key)
+			{
+				break;
+			}
+		}
+		return it;
+	}
+
+	namespace detail
+	{
+		/// @brief Builds the nodes of a document from a structural index.
+		/// Children are gathered on a stack while their container is parsed, then appended to the document in one
+		/// block when it closes. Offsets are absolute until a node is placed, then made relative to it.
+		template <typename TAllocator>
+		class basic_json_document_builder
+		{
+		public:
+#pragma region TYPES
+			using node_list = std::vector<
+				json_node, typename std::allocator_traits<TAllocator>::template rebind_alloc<json_node>>;
+#pragma endregion
+
+#pragma region CREATORS
+			basic_json_document_builder(
+				char const* a_first,
+				char const* a_last,
+				std::span<std::uint32_t const> a_positions,
+				std::size_t a_firstControlPosition,
+				json_string_mode a_stringMode,
+				node_list& a_nodes)
+				: m_first{ a_first }
+				, m_last{ a_last }
+				, m_current{ a_first }
+				, m_positions{ a_positions }
+				, m_firstControlPosition{ a_firstControlPosition }
+				, m_stringMode{ a_stringMode }
+				, m_nodes{ a_nodes }
+				, m_children{ a_nodes.get_allocator() }
+				, m_escapedString{ char_allocator{ a_nodes.get_allocator() } }
+				, m_keyIndex{ index_allocator{ a_nodes.get_allocator() } }
+			{}
+#pragma endregion
+
+#pragma region ACCESSORS
+			/// @brief Provides where parsing stopped: after the parsed value, or where an error was found.
+			[[nodiscard]] auto get_current() const
+			{
+				return m_current;
+			}
+#pragma endregion
+
+#pragma region MANIPULATORS
+			/// @brief Parses the root value, which is stored as the first node.
+			bool parse_root()
+			{
+				// Structural characters outnumber values, which leaves room for most strings
+				m_nodes.clear();
+				m_nodes.reserve(m_positions.size());
+				m_nodes.emplace_back();
+				json_node root;
+				if (!parse_value(root))
+				{
+					return false;
+				}
+				place(root, 0);
+				m_nodes.front() = root;
+				return true;
+			}
+#pragma endregion
+
+		private:
+#pragma region PRIVATE_TYPES
+			using char_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<char>;
+			using index_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<std::uint32_t>;
+			using string_type = std::basic_string<char, std::char_traits<char>, char_allocator>;
+#pragma endregion
+
+#pragma region PRIVATE_DATA
+			char const* m_first;
+			char const* m_last;
+			char const* m_current;
+			std::span<std::uint32_t const> m_positions;
+			std::size_t m_nextPosition = 0;
+			std::size_t m_firstControlPosition;
+			json_string_mode m_stringMode;
+			node_list& m_nodes;
+			node_list m_children;
+			string_type m_escapedString;
+			std::vector<std::uint32_t, index_allocator> m_keyIndex;
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+			[[nodiscard]] char const* peek_token() const
+			{
+				return m_nextPosition < m_positions.size() ? m_first + m_positions[m_nextPosition] : m_last;
+			}
+
+			[[nodiscard]] bool is_followed_by_whitespaces() const
+			{
+				auto const token = peek_token();
+				for (auto current = m_current; current != token; ++current)
+				{
+					if (*current != ' ' && *current != '\n' && *current != '\r' && *current != '\t')
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+			char const* next_token()
+			{
+				auto const token = peek_token();
+				m_nextPosition += token != m_last;
+				return token;
+			}
+
+			bool consume(char const a_char)
+			{
+				auto const token = peek_token();
+				if (token == m_last || *token != a_char)
+				{
+					m_current = token;
+					return false;
+				}
+				++m_nextPosition;
+				m_current = token + 1;
+				return true;
+			}
+
+			/// @brief Makes the offset of a node relative to where it is placed. Empty strings and containers keep a
+			/// null offset, their data is never read.
+			static void place(json_node& a_node, std::size_t const a_index)
+			{
+				if (a_node.has_offset())
+				{
+					a_node.m_offset -= static_cast<std::int64_t>(a_index * sizeof(json_node));
+				}
+			}
+
+			/// @brief Appends raw bytes to the document, padded to a whole number of nodes, and returns their offset.
+			std::int64_t append_bytes(void const* const a_bytes, std::size_t const a_size)
+			{
+				auto const index = m_nodes.size();
+				m_nodes.resize(index + (a_size + sizeof(json_node) - 1) / sizeof(json_node));
+				std::memcpy(m_nodes.data() + index, a_bytes, a_size);
+				return static_cast<std::int64_t>(index * sizeof(json_node));
+			}
+
+			/// @brief Moves the children gathered since first to the document, and returns their offset.
+			std::int64_t append_children(std::size_t const a_first)
+			{
+				auto const index = m_nodes.size();
+				m_nodes.insert(m_nodes.end(), m_children.begin() + a_first, m_children.end());
+				m_children.resize(a_first);
+				for (auto i = index; i < m_nodes.size(); ++i)
+				{
+					place(m_nodes[i], i);
+				}
+				return static_cast<std::int64_t>(index * sizeof(json_node));
+			}
+
+			/// @brief Appends the hash table of the keys of an object right after its members. Only the first member
+			/// of duplicate keys is indexed.
+			void append_key_index(json_node const& a_object)
+			{
+				auto const firstKey = m_nodes.size() - 2 * a_object.m_size;
+				auto const get_key = [this, firstKey](std::size_t const a_index)
+				{
+					return m_nodes[firstKey + 2 * a_index].template get<json_node_string>()->value;
+				};
+
+				m_keyIndex.assign(index_table::get_capacity(a_object.m_size), 0);
+				for (auto index = std::size_t{ 0 }; index < a_object.m_size; ++index)
+				{
+					auto const key = get_key(index);
+					auto const hash = mishs::fnv1a_hash{}(key);
+					auto const isDuplicate = index_table::find(m_keyIndex, hash, index, [&](std::size_t const a_other)
+					{
+						return get_key(a_other) == key;
+					}) != index;
+					if (!isDuplicate)
+					{
+						index_table::insert(m_keyIndex, hash, index);
+					}
+				}
+				append_bytes(m_keyIndex.data(), m_keyIndex.size() * sizeof(std::uint32_t));
+			}
+
+			bool parse_value(json_node& a_node)
+			{
+				auto const token = next_token();
+				m_current = token;
+				if (token == m_last)
+				{
+					return false;
+				}
+
+				switch (*token)
+				{
+				case '"':
+					return parse_string(token, a_node);
+				case '{':
+					return parse_object(a_node);
+				case '[':
+					return parse_array(a_node);
+				case 't':
+				case 'f':
+				case 'n':
+					return parse_literal(token, a_node);
+				default:
+				{
+					std::variant<std::int64_t, std::uint64_t, double> number;
+					if (!parse_json_number(m_current, m_last, number))
+					{
+						return false;
+					}
+					a_node.m_type = json_value_type::number;
+					a_node.m_size = static_cast<std::uint32_t>(number.index());
+					std::visit([&a_node](auto const a_value)
+					{
+						using value_type = std::remove_const_t<decltype(a_value)>;
+						if constexpr (std::is_same_v<value_type, std::int64_t>)
+						{
+							a_node.m_signed = a_value;
+						}
+						else if constexpr (std::is_same_v<value_type, std::uint64_t>)
+						{
+							a_node.m_unsigned = a_value;
+						}
+						else
+						{
+							a_node.m_floating = a_value;
+						}
+					}, number);
+					return true;
+				}
+				}
+			}
+
+			bool parse_literal(char const* const a_token, json_node& a_node)
+			{
+				auto const size = static_cast<std::size_t>(m_last - a_token);
+				auto const matches = [a_token, size](std::string_view const a_literal)
+				{
+					return size >= a_literal.size() && std::string_view{ a_token, a_literal.size() } == a_literal;
+				};
+				if (matches("true") || matches("false"))
+				{
+					a_node.m_type = json_value_type::boolean;
+					a_node.m_boolean = *a_token == 't';
+					m_current = a_token + (a_node.m_boolean ? 4 : 5);
+					return true;
+				}
+				if (matches("null"))
+				{
+					a_node.m_type = json_value_type::null;
+					m_current = a_token + 4;
+					return true;
+				}
+				return false;
+			}
+
+			bool parse_string(char const* const a_openingQuote, json_node& a_node)
+			{
+				auto const closingQuote = next_token();
+				if (closingQuote == m_last)
+				{
+					m_current = m_last;
+					return false;
+				}
+				auto const openingPosition = static_cast<std::size_t>(a_openingQuote - m_first);
+				auto const closingPosition = static_cast<std::size_t>(closingQuote - m_first);
+				if (openingPosition < m_firstControlPosition && m_firstControlPosition < closingPosition)
+				{
+					m_current = m_first + m_firstControlPosition;
+					return false;
+				}
+
+				auto const first = a_openingQuote + 1;
+				auto const size = static_cast<std::size_t>(closingQuote - first);
+				a_node.m_type = json_value_type::string;
+				if (size == 0)
+				{
+					a_node.m_offset = 0;
+				}
+				else if (std::memchr(first, '\\', size) == nullptr)
+				{
+					assert(size < json_node::s_referenceBit);
+					if (m_stringMode == json_string_mode::reference)
+					{
+						a_node.m_size = static_cast<std::uint32_t>(size) | json_node::s_referenceBit;
+						a_node.m_characters = first;
+					}
+					else
+					{
+						a_node.m_size = static_cast<std::uint32_t>(size);
+						a_node.m_offset = append_bytes(first, size);
+					}
+				}
+				else
+				{
+					m_escapedString.clear();
+					basic_json_buffer_parser<char_allocator> parser{ a_openingQuote, m_last };
+					if (!parser.parse_string(m_escapedString))
+					{
+						m_current = parser.get_current();
+						return false;
+					}
+					a_node.m_size = static_cast<std::uint32_t>(m_escapedString.size());
+					a_node.m_offset = append_bytes(m_escapedString.data(), m_escapedString.size());
+				}
+				m_current = closingQuote + 1;
+				return true;
+			}
+
+			bool parse_object(json_node& a_node)
+			{
+				a_node.m_type = json_value_type::object;
+				m_current = m_current + 1;
+				if (consume('}'))
+				{
+					return true;
+				}
+
+				auto const firstChild = m_children.size();
+				while (true)
+				{
+					auto const keyToken = peek_token();
+					if (keyToken == m_last || *keyToken != '"')
+					{
+						m_current = keyToken;
+						return false;
+					}
+					++m_nextPosition;
+					json_node key;
+					if (!parse_string(keyToken, key) || !consume(':'))
+					{
+						return false;
+					}
+					m_children.push_back(key);
+					json_node value;
+					if (!parse_value(value) || !is_followed_by_whitespaces())
+					{
+						return false;
+					}
+					m_children.push_back(value);
+
+					if (consume('}'))
+					{
+						break;
+					}
+					if (!consume(','))
+					{
+						return false;
+					}
+				}
+				a_node.m_size = static_cast<std::uint32_t>((m_children.size() - firstChild) / 2);
+				a_node.m_offset = append_children(firstChild);
+				if (a_node.m_size >= json_node_members::index_threshold)
+				{
+					append_key_index(a_node);
+				}
+				return true;
+			}
+
+			bool parse_array(json_node& a_node)
+			{
+				a_node.m_type = json_value_type::array;
+				m_current = m_current + 1;
+				if (consume(']'))
+				{
+					return true;
+				}
+
+				auto const firstChild = m_children.size();
+				while (true)
+				{
+					json_node value;
+					if (!parse_value(value) || !is_followed_by_whitespaces())
+					{
+						return false;
+					}
+					m_children.push_back(value);
+
+					if (consume(']'))
+					{
+						break;
+					}
+					if (!consume(','))
+					{
+						return false;
+					}
+				}
+				a_node.m_size = static_cast<std::uint32_t>(m_children.size() - firstChild);
+				a_node.m_offset = append_children(firstChild);
+				return true;
+			}
+#pragma endregion
+		};
+	}
+
+	/// @brief A JSON document stored as a single array of 16 bytes nodes, strings included.
+	/// Unlike basic_json_value, which allocates every value separately, a document is built with one growing
+	/// allocation and destroyed with a single free. Its values are read through json_node, which misvi::json_reader
+	/// accepts as its value type.
+	/// Objects keep all members of duplicate keys, find returns the first one as basic_json_object does.
+	/// With json_string_mode::reference, strings without escape sequences point into the source instead.
+	template <typename TAllocator = std::allocator<char>>
+	class basic_json_document
+	{
+	public:
+#pragma region TYPES
+		using value_type = json_node;
+		using allocator_type = typename std::allocator_traits<TAllocator>::template rebind_alloc<json_node>;
+#pragma endregion
+
+#pragma region CREATORS
+		/// @brief Creates an empty document, whose root is null.
+		explicit basic_json_document(TAllocator const& a_allocator = {})
+			: m_nodes{ allocator_type{ a_allocator } }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Provides the root value.
+		[[nodiscard]] json_node const& get_root() const
+		{
+			static json_node const s_null{};
+			return m_nodes.empty() ? s_null : m_nodes.front();
+		}
+
+		/// @brief Provides the number of bytes used by the nodes and strings of the document.
+		[[nodiscard]] std::size_t get_memory_size() const
+		{
+			return m_nodes.size() * sizeof(json_node);
+		}
+
+		/// @brief Provides the allocator of the document.
+		[[nodiscard]] auto get_allocator() const
+		{
+			return TAllocator{ m_nodes.get_allocator() };
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Replaces the content of the document with the JSON value in [first, last), using the given index.
+		/// See parse_json for the result.
+		template <typename TIndexAllocator>
+		std::from_chars_result parse(
+			char const* const a_first,
+			char const* const a_last,
+			basic_json_structural_index<TIndexAllocator>& a_index,
+			json_string_mode const a_stringMode = json_string_mode::copy)
+		{
+			a_index.build(a_first, a_last);
+			detail::basic_json_document_builder<TAllocator> builder{
+				a_first,
+				a_last,
+				a_index.get_positions(),
+				a_index.get_first_control_position(),
+				a_stringMode,
+				m_nodes };
+			if (!builder.parse_root())
+			{
+				m_nodes.clear();
+				return { builder.get_current(), std::errc::invalid_argument };
+			}
+			return { builder.get_current(), std::errc{} };
+		}
+
+		/// @brief Empties the document, keeping its memory.
+		void clear()
+		{
+			m_nodes.clear();
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		std::vector<json_node, allocator_type> m_nodes;
+#pragma endregion
+	};
+
+	using json_document = basic_json_document<>;
+
+	namespace pmr
+	{
+		using json_document = basic_json_document<std::pmr::polymorphic_allocator<char>>;
+	}
+
+	/// @brief Parses a JSON document from [first, last), see the basic_json_value overload.
+	template <typename TAllocator, typename TIndexAllocator>
+	std::from_chars_result parse_json(
+		char const* const a_first,
+		char const* const a_last,
+		basic_json_document<TAllocator>& a_document,
+		basic_json_structural_index<TIndexAllocator>& a_index,
+		json_string_mode const a_stringMode = json_string_mode::copy)
+	{
+		return a_document.parse(a_first, a_last, a_index, a_stringMode);
+	}
+
+	/// @brief Parses a JSON document from [first, last), see the basic_json_value overload.
+	template <typename TAllocator>
+	std::from_chars_result parse_json(
+		char const* const a_first,
+		char const* const a_last,
+		basic_json_document<TAllocator>& a_document,
+		json_string_mode const a_stringMode = json_string_mode::copy)
+	{
+		json_structural_index index;
+		return a_document.parse(a_first, a_last, index, a_stringMode);
+	}
+
+	/// @brief Parses a JSON document from a string, see the pointer overload.
+	template <typename TAllocator>
+	std::from_chars_result parse_json(
+		std::string_view const a_input,
+		basic_json_document<TAllocator>& a_document,
+		json_string_mode const a_stringMode = json_string_mode::copy)
+	{
+		return parse_json(a_input.data(), a_input.data() + a_input.size(), a_document, a_stringMode);
+	}
+}
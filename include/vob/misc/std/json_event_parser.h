@@ -0,0 +1,519 @@
+#pragma once
+
+#include "json_parser.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+
+namespace vob::mistd
+{
+	/// @brief Events produced while walking a JSON document with a basic_json_event_parser.
+	enum class json_event
+	{
+		none,
+		start_object,
+		end_object,
+		start_array,
+		end_array,
+		key,
+		null,
+		boolean,
+		number,
+		string,
+		end_of_input,
+		error
+	};
+
+	/// @brief Chunked input reading a stream.
+	class json_istream_source
+	{
+	public:
+#pragma region CREATORS
+		explicit json_istream_source(std::istream& a_inputStream)
+			: m_inputStream{ a_inputStream }
+		{}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Reads up to a_size characters, returns how many were read, 0 at the end of the stream.
+		std::size_t operator()(char* const a_buffer, std::size_t const a_size)
+		{
+			m_inputStream.read(a_buffer, static_cast<std::streamsize>(a_size));
+			return static_cast<std::size_t>(m_inputStream.gcount());
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		std::istream& m_inputStream;
+#pragma endregion
+	};
+
+	/// @brief Chunked input reading a buffer already in memory.
+	class json_string_source
+	{
+	public:
+#pragma region CREATORS
+		explicit json_string_source(std::string_view const a_text)
+			: m_remaining{ a_text }
+		{}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Reads up to a_size characters, returns how many were read, 0 at the end of the buffer.
+		std::size_t operator()(char* const a_buffer, std::size_t const a_size)
+		{
+			auto const size = std::min(a_size, m_remaining.size());
+			std::memcpy(a_buffer, m_remaining.data(), size);
+			m_remaining.remove_prefix(size);
+			return size;
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		std::string_view m_remaining;
+#pragma endregion
+	};
+
+	/// @brief Pull parser producing the events of a JSON document read by chunks from a source, so a document can be
+	/// consumed without ever being held whole in memory, as text or as a basic_json_value tree.
+	/// TSource is called as std::size_t(char* buffer, std::size_t size) and returns 0 at the end of the input.
+	/// Only the token being read is buffered: memory use is bounded by the chunk size and the largest string or
+	/// number, plus one byte per nesting level.
+	template <typename TSource, typename TAllocator = std::allocator<char>>
+	class basic_json_event_parser
+	{
+	public:
+#pragma region TYPES
+		using string_type = std::basic_string<char, std::char_traits<char>, TAllocator>;
+		using number_value_type = decltype(basic_json_number<TAllocator>::value);
+#pragma endregion
+
+#pragma region CREATORS
+		/// @brief Creates a parser reading chunks of a_chunkSize characters from a source.
+		explicit basic_json_event_parser(
+			TSource a_source,
+			std::size_t const a_chunkSize = 1 << 16,
+			TAllocator const& a_allocator = {})
+			: m_source{ std::move(a_source) }
+			, m_buffer(std::max(a_chunkSize, std::size_t{ 1 }), '\0', a_allocator)
+			, m_containers{ a_allocator }
+			, m_string{ a_allocator }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Provides the last event returned by next, or none before the first call.
+		[[nodiscard]] auto get_event() const
+		{
+			return m_event;
+		}
+
+		/// @brief Provides the number of objects and arrays the parser is in.
+		[[nodiscard]] auto get_depth() const
+		{
+			return m_containers.size();
+		}
+
+		/// @brief Provides the decoded text of the last key or string event, valid until the next call to next.
+		[[nodiscard]] std::string_view get_string() const
+		{
+			return m_string;
+		}
+
+		/// @brief Provides the value of the last number event.
+		[[nodiscard]] auto const& get_number() const
+		{
+			return m_number;
+		}
+
+		/// @brief Provides the value of the last boolean event.
+		[[nodiscard]] auto get_boolean() const
+		{
+			return m_boolean;
+		}
+
+		[[nodiscard]] auto get_allocator() const
+		{
+			return m_buffer.get_allocator();
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Reads the next event. Once end_of_input or error is returned, it is returned by all further calls.
+		json_event next()
+		{
+			if (m_event == json_event::end_of_input || m_event == json_event::error)
+			{
+				return m_event;
+			}
+
+			if (!skip_whitespaces())
+			{
+				return m_event = m_expectation == expectation::end_of_input
+					? json_event::end_of_input
+					: json_event::error;
+			}
+
+			auto c = m_buffer[m_current];
+			switch (m_expectation)
+			{
+			case expectation::end_of_input:
+				return fail();
+			case expectation::separator_or_end:
+				if (c != ',')
+				{
+					return read_end(c);
+				}
+				++m_current;
+				if (!skip_whitespaces())
+				{
+					return fail();
+				}
+				c = m_buffer[m_current];
+				m_expectation = m_containers.back() == '{' ? expectation::key : expectation::value;
+				break;
+			case expectation::key_or_end:
+			case expectation::value_or_end:
+				if (c == '}' || c == ']')
+				{
+					return read_end(c);
+				}
+				m_expectation = m_expectation == expectation::key_or_end ? expectation::key : expectation::value;
+				break;
+			default:
+				break;
+			}
+
+			if (m_expectation == expectation::key)
+			{
+				if (c != '"' || !read_string() || !skip_whitespaces() || m_buffer[m_current] != ':')
+				{
+					return fail();
+				}
+				++m_current;
+				m_expectation = expectation::value;
+				return m_event = json_event::key;
+			}
+			return read_value(c);
+		}
+
+		/// @brief Skips the rest of the value whose first event was just read, so the last event read is its last
+		/// one. Returns false on error.
+		bool skip()
+		{
+			if (m_event == json_event::start_object || m_event == json_event::start_array)
+			{
+				auto const depth = m_containers.size();
+				while (m_containers.size() >= depth && next() != json_event::error) {}
+			}
+			return m_event != json_event::error;
+		}
+
+		/// @brief Counts the elements of the array whose start_array event was just read, by scanning ahead of the
+		/// current position. The text of the array stays buffered until it is read.
+		std::size_t count_array_elements()
+		{
+			std::size_t commaCount = 0;
+			std::size_t depth = 0;
+			auto isEmpty = true;
+			for (std::size_t offset = 0; is_available(offset); ++offset)
+			{
+				auto const c = m_buffer[m_current + offset];
+				switch (c)
+				{
+				case '"':
+					offset = find_string_end(offset);
+					isEmpty = false;
+					break;
+				case '[':
+				case '{':
+					++depth;
+					isEmpty = false;
+					break;
+				case ']':
+				case '}':
+					if (depth == 0)
+					{
+						return isEmpty ? 0 : commaCount + 1;
+					}
+					--depth;
+					break;
+				case ',':
+					commaCount += depth == 0 ? 1 : 0;
+					break;
+				case ' ':
+				case '\t':
+				case '\n':
+				case '\r':
+					break;
+				default:
+					isEmpty = false;
+					break;
+				}
+			}
+			return isEmpty ? 0 : commaCount + 1;
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_TYPES
+		/// @brief What may come next in the document.
+		enum class expectation
+		{
+			value,
+			value_or_end,
+			key,
+			key_or_end,
+			separator_or_end,
+			end_of_input
+		};
+#pragma endregion
+
+#pragma region PRIVATE_DATA
+		TSource m_source;
+		std::vector<char, TAllocator> m_buffer;
+		/// @brief Characters of the buffer not read yet are in [m_current, m_end).
+		std::size_t m_current = 0;
+		std::size_t m_end = 0;
+		bool m_isSourceEnd = false;
+		/// @brief Opening character of each object or array the parser is in.
+		std::vector<char, TAllocator> m_containers;
+		expectation m_expectation = expectation::value;
+		json_event m_event = json_event::none;
+		string_type m_string;
+		number_value_type m_number;
+		bool m_boolean = false;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		/// @brief Reads more input, keeping the characters from the current position at the start of the buffer.
+		/// Returns false at the end of the input.
+		bool fill()
+		{
+			if (m_isSourceEnd)
+			{
+				return false;
+			}
+
+			if (m_current != 0)
+			{
+				std::copy(m_buffer.begin() + m_current, m_buffer.begin() + m_end, m_buffer.begin());
+				m_end -= m_current;
+				m_current = 0;
+			}
+			if (m_end == m_buffer.size())
+			{
+				m_buffer.resize(2 * m_buffer.size());
+			}
+
+			auto const count = m_source(m_buffer.data() + m_end, m_buffer.size() - m_end);
+			if (count == 0)
+			{
+				m_isSourceEnd = true;
+				return false;
+			}
+			m_end += count;
+			return true;
+		}
+
+		/// @brief Whether the character at a_offset from the current position is in the input, reading it if needed.
+		bool is_available(std::size_t const a_offset)
+		{
+			while (m_current + a_offset >= m_end)
+			{
+				if (!fill())
+				{
+					return false;
+				}
+			}
+			return true;
+		}
+
+		/// @brief Skips whitespaces, returns false at the end of the input.
+		bool skip_whitespaces()
+		{
+			while (is_available(0))
+			{
+				switch (m_buffer[m_current])
+				{
+				case ' ':
+				case '\t':
+				case '\n':
+				case '\r':
+					++m_current;
+					break;
+				default:
+					return true;
+				}
+			}
+			return false;
+		}
+
+		/// @brief Provides the offset of the quote closing the string opened at a_offset, or the offset of the end
+		/// of the input if it is never closed.
+		std::size_t find_string_end(std::size_t a_offset)
+		{
+			++a_offset;
+			while (is_available(a_offset))
+			{
+				auto const first = m_buffer.data() + m_current + a_offset;
+				auto const last = m_buffer.data() + m_end;
+				auto const quote = static_cast<char const*>(std::memchr(first, '"', static_cast<std::size_t>(last - first)));
+				if (quote == nullptr)
+				{
+					a_offset = m_end - m_current;
+					continue;
+				}
+
+				// A quote preceded by an odd number of backslashes is escaped
+				auto backslash = quote;
+				while (*(backslash - 1) == '\\')
+				{
+					--backslash;
+				}
+				a_offset = static_cast<std::size_t>(quote - (m_buffer.data() + m_current));
+				if ((quote - backslash) % 2 == 0)
+				{
+					return a_offset;
+				}
+				++a_offset;
+			}
+			return m_end - m_current;
+		}
+
+		json_event fail()
+		{
+			return m_event = json_event::error;
+		}
+
+		/// @brief Sets what may follow a value that was just read.
+		void end_value()
+		{
+			m_expectation = m_containers.empty() ? expectation::end_of_input : expectation::separator_or_end;
+		}
+
+		json_event read_end(char const a_char)
+		{
+			if (m_containers.empty() || a_char != (m_containers.back() == '{' ? '}' : ']'))
+			{
+				return fail();
+			}
+			++m_current;
+			m_containers.pop_back();
+			end_value();
+			return m_event = a_char == '}' ? json_event::end_object : json_event::end_array;
+		}
+
+		json_event read_value(char const a_char)
+		{
+			switch (a_char)
+			{
+			case '{':
+			case '[':
+				++m_current;
+				m_containers.push_back(a_char);
+				if (a_char == '{')
+				{
+					m_expectation = expectation::key_or_end;
+					return m_event = json_event::start_object;
+				}
+				m_expectation = expectation::value_or_end;
+				return m_event = json_event::start_array;
+			case '"':
+				if (!read_string())
+				{
+					return fail();
+				}
+				end_value();
+				return m_event = json_event::string;
+			case 't':
+				m_boolean = true;
+				return read_literal("true", json_event::boolean);
+			case 'f':
+				m_boolean = false;
+				return read_literal("false", json_event::boolean);
+			case 'n':
+				return read_literal("null", json_event::null);
+			default:
+				return read_number();
+			}
+		}
+
+		json_event read_literal(std::string_view const a_literal, json_event const a_event)
+		{
+			if (!is_available(a_literal.size() - 1)
+				|| std::memcmp(m_buffer.data() + m_current, a_literal.data(), a_literal.size()) != 0)
+			{
+				return fail();
+			}
+			m_current += a_literal.size();
+			end_value();
+			return m_event = a_event;
+		}
+
+		/// @brief Reads the string starting at the current position into m_string.
+		bool read_string()
+		{
+			auto const end = find_string_end(0);
+			if (!is_available(end))
+			{
+				return false;
+			}
+
+			auto const first = m_buffer.data() + m_current;
+			m_string.clear();
+			detail::basic_json_buffer_parser<TAllocator> parser{ first, first + end + 1 };
+			if (!parser.parse_string(m_string))
+			{
+				return false;
+			}
+			m_current += end + 1;
+			return true;
+		}
+
+		json_event read_number()
+		{
+			std::size_t size = 0;
+			while (is_available(size))
+			{
+				auto const c = m_buffer[m_current + size];
+				if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+				{
+					break;
+				}
+				++size;
+			}
+
+			auto const first = m_buffer.data() + m_current;
+			auto current = static_cast<char const*>(first);
+			if (size == 0 || !detail::parse_json_number(current, first + size, m_number) || current != first + size)
+			{
+				return fail();
+			}
+			m_current += size;
+			end_value();
+			return m_event = json_event::number;
+		}
+#pragma endregion
+	};
+
+	template <typename TSource>
+	using json_event_parser = basic_json_event_parser<TSource>;
+
+	namespace pmr
+	{
+		template <typename TSource>
+		using json_event_parser = basic_json_event_parser<TSource, std::pmr::polymorphic_allocator<char>>;
+	}
+}
@@ -0,0 +1,669 @@
+#pragma once
+
+#include "json_parser.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+
+
+namespace vob::mistd
+{
+	namespace detail
+	{
+		inline char const* skip_json_whitespaces(char const* a_current, char const* const a_last)
+		{
+			while (a_current != a_last
+				&& (*a_current == ' ' || *a_current == '\t' || *a_current == '\n' || *a_current == '\r'))
+			{
+				++a_current;
+			}
+			return a_current;
+		}
+
+		/// @brief Provides the quote closing the string opened at a_quote, or a_last if there is none.
+		inline char const* find_json_string_end(char const* const a_quote, char const* const a_last)
+		{
+			auto current = a_quote + 1;
+			while (current != a_last)
+			{
+				auto const quote = static_cast<char const*>(
+					std::memchr(current, '"', static_cast<std::size_t>(a_last - current)));
+				if (quote == nullptr)
+				{
+					return a_last;
+				}
+
+				// A quote preceded by an odd number of backslashes is escaped
+				auto backslash = quote;
+				while (*(backslash - 1) == '\\')
+				{
+					--backslash;
+				}
+				if ((quote - backslash) % 2 == 0)
+				{
+					return quote;
+				}
+				current = quote + 1;
+			}
+			return a_last;
+		}
+
+		/// @brief One bit per byte of a 64 bytes block, for the characters that matter to skip objects and arrays.
+		struct json_bracket_masks
+		{
+			std::uint64_t backslashes;
+			std::uint64_t quotes;
+			std::uint64_t opens;
+			std::uint64_t closes;
+		};
+
+		inline json_bracket_masks classify_json_brackets(char const* const a_block)
+		{
+			json_bracket_masks masks{};
+#ifdef VOB_MISTD_JSON_X64
+			for (auto i = 0u; i < 4; ++i)
+			{
+				auto const chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a_block + 16 * i));
+				// '[' and ']' only differ from '{' and '}' by the 0x20 bit
+				auto const lowered = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+				auto const shift = 16 * i;
+				masks.backslashes |= get_sse2_mask(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')), shift);
+				masks.quotes |= get_sse2_mask(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')), shift);
+				masks.opens |= get_sse2_mask(_mm_cmpeq_epi8(lowered, _mm_set1_epi8('{')), shift);
+				masks.closes |= get_sse2_mask(_mm_cmpeq_epi8(lowered, _mm_set1_epi8('}')), shift);
+			}
+#else
+			for (auto i = 0u; i < 64; ++i)
+			{
+				auto const bit = std::uint64_t{ 1 } << i;
+				switch (a_block[i])
+				{
+				case '\\': masks.backslashes |= bit; break;
+				case '"': masks.quotes |= bit; break;
+				case '[': case '{': masks.opens |= bit; break;
+				case ']': case '}': masks.closes |= bit; break;
+				default: break;
+				}
+			}
+#endif
+			return masks;
+		}
+
+		/// @brief Provides the end of the object or array starting at a_first, or a_last if it is not closed.
+		/// Brackets outside of strings are found 64 bytes at a time, and only walked one by one in the blocks where
+		/// the depth may reach zero.
+		inline char const* skip_json_container(char const* const a_first, char const* const a_last)
+		{
+			std::uint64_t isEscaped = 0;
+			std::uint64_t isInString = 0;
+			std::size_t depth = 0;
+			auto const size = static_cast<std::size_t>(a_last - a_first);
+			for (std::size_t offset = 0; offset < size; offset += 64)
+			{
+				// The last block is padded with spaces, which are not structural
+				auto const block = a_first + offset;
+				auto const remaining = size - offset;
+				char padded[64];
+				auto data = block;
+				if (remaining < 64)
+				{
+					std::memset(padded, ' ', sizeof(padded));
+					std::memcpy(padded, block, remaining);
+					data = padded;
+				}
+
+				auto const masks = classify_json_brackets(data);
+				auto const quotes = masks.quotes & ~find_json_escaped(masks.backslashes, isEscaped);
+				auto const inString = prefix_xor(quotes) ^ isInString;
+				isInString = static_cast<std::uint64_t>(static_cast<std::int64_t>(inString) >> 63);
+				auto const opens = masks.opens & ~inString;
+				auto const closes = masks.closes & ~inString;
+
+				auto const closeCount = static_cast<std::size_t>(std::popcount(closes));
+				if (closeCount < depth)
+				{
+					depth += static_cast<std::size_t>(std::popcount(opens)) - closeCount;
+					continue;
+				}
+				for (auto brackets = opens | closes; brackets != 0; brackets &= brackets - 1)
+				{
+					auto const bit = brackets & (0 - brackets);
+					if ((opens & bit) != 0)
+					{
+						++depth;
+					}
+					else if (--depth == 0)
+					{
+						return block + std::countr_zero(bit) + 1;
+					}
+				}
+			}
+			return a_last;
+		}
+
+		/// @brief Provides the end of the value starting at a_first, without decoding or validating it: objects and
+		/// arrays are skipped by matching brackets, scalars end at the next separator.
+		inline char const* skip_json_value(char const* const a_first, char const* const a_last)
+		{
+			if (a_first == a_last)
+			{
+				return a_last;
+			}
+
+			switch (*a_first)
+			{
+			case '"':
+			{
+				auto const end = find_json_string_end(a_first, a_last);
+				return end == a_last ? a_last : end + 1;
+			}
+			case '[':
+			case '{':
+				return skip_json_container(a_first, a_last);
+			default:
+			{
+				auto current = a_first;
+				while (current != a_last && *current != ',' && *current != ']' && *current != '}'
+					&& *current != ' ' && *current != '\t' && *current != '\n' && *current != '\r')
+				{
+					++current;
+				}
+				return current;
+			}
+			}
+		}
+	}
+
+	/// @brief View of a null value.
+	struct json_lazy_null
+	{
+		constexpr static auto type = json_value_type::null;
+	};
+
+	/// @brief View of a boolean value.
+	struct json_lazy_boolean
+	{
+		constexpr static auto type = json_value_type::boolean;
+
+		bool value;
+	};
+
+	/// @brief View of a number value, decoded when accessed.
+	struct json_lazy_number
+	{
+		constexpr static auto type = json_value_type::number;
+
+		std::variant<std::int64_t, std::uint64_t, double> value;
+	};
+
+	/// @brief View of a string value, decoded when accessed.
+	struct json_lazy_string
+	{
+		constexpr static auto type = json_value_type::string;
+
+		std::string value;
+	};
+
+	struct json_lazy_array;
+	struct json_lazy_object;
+
+	/// @brief Value of a JSON text that is only scanned or decoded when accessed, so reading a few values out of a
+	/// large text costs roughly what those values take to decode, plus a bracket-matching scan over the values
+	/// skipped to reach them.
+	/// Errors are found lazily as well: accessing a malformed value provides nothing.
+	/// The text must outlive the value and the views it provides.
+	class json_lazy_value
+	{
+	public:
+#pragma region TYPES
+		using null_type = json_lazy_null;
+		using boolean_type = json_lazy_boolean;
+		using number_type = json_lazy_number;
+		using string_type = json_lazy_string;
+		using array_type = json_lazy_array;
+		using object_type = json_lazy_object;
+#pragma endregion
+
+#pragma region CREATORS
+		/// @brief Creates a value that is none of the JSON types.
+		json_lazy_value() = default;
+
+		/// @brief Creates the value of a JSON text.
+		explicit json_lazy_value(std::string_view const a_text)
+			: json_lazy_value{ a_text.data(), a_text.data() + a_text.size() }
+		{}
+
+		/// @brief Creates the value starting at the first non-whitespace character of [first, last).
+		json_lazy_value(char const* const a_first, char const* const a_last)
+			: m_first{ detail::skip_json_whitespaces(a_first, a_last) }
+			, m_last{ a_last }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Provides the text of the value, found by skipping it.
+		[[nodiscard]] std::string_view get_text() const
+		{
+			return { m_first, static_cast<std::size_t>(detail::skip_json_value(m_first, m_last) - m_first) };
+		}
+
+		/// @brief Provides a view of the value if it is a valid TView::type.
+		template <typename TView>
+		[[nodiscard]] std::optional<TView> get() const
+		{
+			if (m_first == m_last)
+			{
+				return std::nullopt;
+			}
+
+			auto const c = *m_first;
+			if constexpr (std::is_same_v<TView, null_type>)
+			{
+				if (is_literal("null"))
+				{
+					return null_type{};
+				}
+			}
+			else if constexpr (std::is_same_v<TView, boolean_type>)
+			{
+				if (is_literal("true") || is_literal("false"))
+				{
+					return boolean_type{ c == 't' };
+				}
+			}
+			else if constexpr (std::is_same_v<TView, number_type>)
+			{
+				number_type number;
+				auto current = m_first;
+				if ((c == '-' || (c >= '0' && c <= '9'))
+					&& detail::parse_json_number(current, m_last, number.value)
+					&& current == detail::skip_json_value(m_first, m_last))
+				{
+					return number;
+				}
+			}
+			else if constexpr (std::is_same_v<TView, string_type>)
+			{
+				string_type string;
+				detail::basic_json_buffer_parser<std::allocator<char>> parser{ m_first, m_last };
+				if (c == '"' && parser.parse_string(string.value))
+				{
+					return string;
+				}
+			}
+			else if constexpr (std::is_same_v<TView, array_type>)
+			{
+				if (c == '[')
+				{
+					return TView{ *this };
+				}
+			}
+			else if constexpr (std::is_same_v<TView, object_type>)
+			{
+				if (c == '{')
+				{
+					return TView{ *this };
+				}
+			}
+			return std::nullopt;
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		char const* m_first = nullptr;
+		char const* m_last = nullptr;
+		/// @brief For arrays, start of the element m_cursorIndex, for objects, start of the member after the last one
+		/// found, so sequential accesses resume where the previous one stopped.
+		mutable char const* m_cursor = nullptr;
+		mutable std::size_t m_cursorIndex = 0;
+		/// @brief Number of elements or members, counted once when first needed.
+		mutable std::optional<std::size_t> m_itemCount;
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+		[[nodiscard]] bool is_literal(std::string_view const a_literal) const
+		{
+			return static_cast<std::size_t>(m_last - m_first) >= a_literal.size()
+				&& std::memcmp(m_first, a_literal.data(), a_literal.size()) == 0
+				&& m_first + a_literal.size() == detail::skip_json_value(m_first, m_last);
+		}
+
+		/// @brief Provides the first element or member of an array or object, or its closing bracket.
+		[[nodiscard]] char const* get_first_item() const
+		{
+			return detail::skip_json_whitespaces(m_first + 1, m_last);
+		}
+
+		/// @brief Provides the element or member after the one at a_item, or the closing bracket, or m_last if the
+		/// text is malformed.
+		[[nodiscard]] char const* get_next_item(char const* a_item) const
+		{
+			if (*m_first == '{')
+			{
+				// Skip the key and colon
+				a_item = detail::find_json_string_end(a_item, m_last);
+				a_item = detail::skip_json_whitespaces(a_item == m_last ? m_last : a_item + 1, m_last);
+				if (a_item == m_last || *a_item != ':')
+				{
+					return m_last;
+				}
+				a_item = detail::skip_json_whitespaces(a_item + 1, m_last);
+			}
+			a_item = detail::skip_json_whitespaces(detail::skip_json_value(a_item, m_last), m_last);
+			if (a_item != m_last && *a_item == ',')
+			{
+				return detail::skip_json_whitespaces(a_item + 1, m_last);
+			}
+			return a_item;
+		}
+
+		/// @brief Whether a_item is an element or member rather than the closing bracket or end of the text.
+		[[nodiscard]] bool is_item(char const* const a_item) const
+		{
+			return a_item != m_last && *a_item != ']' && *a_item != '}';
+		}
+
+		/// @brief Provides the element or member at a_index, resuming from the last one accessed when possible.
+		[[nodiscard]] char const* get_item(std::size_t const a_index) const
+		{
+			if (m_cursor == nullptr || a_index < m_cursorIndex)
+			{
+				m_cursor = get_first_item();
+				m_cursorIndex = 0;
+			}
+			while (m_cursorIndex < a_index && is_item(m_cursor))
+			{
+				m_cursor = get_next_item(m_cursor);
+				++m_cursorIndex;
+			}
+			return m_cursorIndex == a_index ? m_cursor : m_last;
+		}
+
+		[[nodiscard]] std::size_t get_item_count() const
+		{
+			if (!m_itemCount.has_value())
+			{
+				std::size_t count = 0;
+				for (auto item = get_first_item(); is_item(item); item = get_next_item(item))
+				{
+					++count;
+				}
+				m_itemCount = count;
+			}
+			return *m_itemCount;
+		}
+#pragma endregion
+
+		friend class json_lazy_elements;
+		friend class json_lazy_members;
+	};
+
+	/// @brief Elements of an array value, found by skipping the ones before them.
+	/// Elements are best accessed by increasing index: the array value remembers where the last one accessed ends.
+	class json_lazy_elements
+	{
+	public:
+#pragma region CREATORS
+		json_lazy_elements(json_lazy_value const& a_array);
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Counts the elements, scanning the whole array the first time.
+		[[nodiscard]] std::size_t size() const;
+
+		[[nodiscard]] bool empty() const;
+
+		/// @brief Provides an element, valid until the next call to this accessor.
+		[[nodiscard]] json_lazy_value const& operator[](std::size_t a_index) const;
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		json_lazy_value const& m_array;
+		mutable std::optional<json_lazy_value> m_element;
+#pragma endregion
+	};
+
+	/// @brief View of an array value.
+	struct json_lazy_array
+	{
+		constexpr static auto type = json_value_type::array;
+
+		json_lazy_elements data;
+	};
+
+	/// @brief Members of an object value, found by scanning the object's keys and skipping the values in between.
+	class json_lazy_members
+	{
+	public:
+#pragma region TYPES
+		class iterator;
+#pragma endregion
+
+#pragma region CREATORS
+		json_lazy_members(json_lazy_value const& a_object)
+			: m_object{ a_object }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Counts the members, scanning the whole object the first time.
+		[[nodiscard]] std::size_t size() const;
+
+		[[nodiscard]] bool empty() const;
+
+		[[nodiscard]] iterator begin() const;
+
+		[[nodiscard]] iterator end() const;
+
+		/// @brief Finds a member with a key, or end. The search starts after the last member found and wraps
+		/// around, so with duplicate keys it is not always the first member that is found.
+		[[nodiscard]] iterator find(std::string_view a_key) const;
+
+		/// @brief Finds a member with a key, or end. Keys are compared in place, so the hash is not needed.
+		[[nodiscard]] iterator find(std::string_view a_key, std::size_t a_hash) const;
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		json_lazy_value const& m_object;
+#pragma endregion
+	};
+
+	/// @brief View of an object value.
+	struct json_lazy_object
+	{
+		constexpr static auto type = json_value_type::object;
+
+		json_lazy_members data;
+	};
+
+	/// @brief Member of an object value, with its key decoded.
+	struct json_lazy_member
+	{
+		std::string first;
+		json_lazy_value second;
+	};
+
+	/// @brief Forward iterator over the members of an object.
+	class json_lazy_members::iterator
+	{
+	public:
+#pragma region TYPES
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = json_lazy_member;
+		using difference_type = std::ptrdiff_t;
+		using pointer = json_lazy_member const*;
+		using reference = json_lazy_member const&;
+#pragma endregion
+
+#pragma region CREATORS
+		iterator() = default;
+
+		iterator(json_lazy_value const& a_object, char const* const a_member)
+			: m_object{ &a_object }
+			, m_current{ a_member }
+		{
+			load();
+		}
+#pragma endregion
+
+#pragma region ACCESSORS
+		[[nodiscard]] reference operator*() const
+		{
+			return m_member;
+		}
+
+		[[nodiscard]] pointer operator->() const
+		{
+			return &m_member;
+		}
+
+		[[nodiscard]] bool operator==(iterator const& a_other) const
+		{
+			return m_current == a_other.m_current;
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		iterator& operator++()
+		{
+			m_current = m_object->get_next_item(m_current);
+			load();
+			return *this;
+		}
+
+		iterator operator++(int)
+		{
+			auto copy = *this;
+			++*this;
+			return copy;
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		json_lazy_value const* m_object = nullptr;
+		/// @brief Key of the current member, or nullptr past the last one.
+		char const* m_current = nullptr;
+		json_lazy_member m_member;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		/// @brief Decodes the key of the current member and finds its value.
+		void load()
+		{
+			if (m_current != nullptr && m_object->is_item(m_current))
+			{
+				auto const last = m_object->m_last;
+				detail::basic_json_buffer_parser<std::allocator<char>> parser{ m_current, last };
+				m_member.first.clear();
+				if (*m_current == '"' && parser.parse_string(m_member.first))
+				{
+					auto const colon = detail::skip_json_whitespaces(parser.get_current(), last);
+					if (colon != last && *colon == ':')
+					{
+						m_member.second = json_lazy_value{ colon + 1, last };
+						return;
+					}
+				}
+			}
+			m_current = nullptr;
+		}
+#pragma endregion
+	};
+
+	inline json_lazy_elements::json_lazy_elements(json_lazy_value const& a_array)
+		: m_array{ a_array }
+	{}
+
+	inline std::size_t json_lazy_elements::size() const
+	{
+		return m_array.get_item_count();
+	}
+
+	inline bool json_lazy_elements::empty() const
+	{
+		return !m_array.is_item(m_array.get_first_item());
+	}
+
+	inline json_lazy_value const& json_lazy_elements::operator[](std::size_t const a_index) const
+	{
+		auto const element = m_array.get_item(a_index);
+		m_element.emplace(element, m_array.is_item(element) ? m_array.m_last : element);
+		return *m_element;
+	}
+
+	inline std::size_t json_lazy_members::size() const
+	{
+		return m_object.get_item_count();
+	}
+
+	inline bool json_lazy_members::empty() const
+	{
+		return !m_object.is_item(m_object.get_first_item());
+	}
+
+	inline json_lazy_members::iterator json_lazy_members::begin() const
+	{
+		return iterator{ m_object, m_object.get_first_item() };
+	}
+
+	inline json_lazy_members::iterator json_lazy_members::end() const
+	{
+		return {};
+	}
+
+	inline json_lazy_members::iterator json_lazy_members::find(
+		std::string_view const a_key,
+		[[maybe_unused]] std::size_t const a_hash) const
+	{
+		return find(a_key);
+	}
+
+	inline json_lazy_members::iterator json_lazy_members::find(std::string_view const a_key) const
+	{
+		auto const last = m_object.m_last;
+		auto const isMatch = [this, a_key, last](char const* const a_member)
+		{
+			// Keys without escape sequences are compared in place, other ones are decoded
+			auto const keyLast = detail::find_json_string_end(a_member, last);
+			std::string_view const rawKey{ a_member + 1, static_cast<std::size_t>(keyLast - a_member - 1) };
+			return rawKey.find('\\') == std::string_view::npos
+				? rawKey == a_key
+				: iterator{ m_object, a_member }->first == a_key;
+		};
+
+		// Members are searched from the one after the last found, so members read in order are each found after
+		// skipping only the ones in between
+		auto const first = m_object.get_first_item();
+		auto const cursor = m_object.m_cursor != nullptr ? m_object.m_cursor : first;
+		for (auto const& [searchFirst, searchLast] : { std::pair{ cursor, last }, std::pair{ first, cursor } })
+		{
+			for (auto member = searchFirst;
+				member != searchLast && m_object.is_item(member);
+				member = m_object.get_next_item(member))
+			{
+				if (*member != '"')
+				{
+					return end();
+				}
+				if (isMatch(member))
+				{
+					m_object.m_cursor = m_object.get_next_item(member);
+					return iterator{ m_object, member };
+				}
+			}
+		}
+		return end();
+	}
+}
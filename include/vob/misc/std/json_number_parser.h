@@ -0,0 +1,265 @@
+#pragma once
+
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include <variant>
+
+
+namespace vob::mistd
+{
+	namespace detail
+	{
+		/// @brief Whether the 8 bytes of a little-endian word are all ASCII digits.
+		inline bool is_eight_digits(std::uint64_t const a_chars)
+		{
+			return ((a_chars & 0xF0F0'F0F0'F0F0'F0F0) | (((a_chars + 0x0606'0606'0606'0606) & 0xF0F0'F0F0'F0F0'F0F0) >> 4))
+				== 0x3333'3333'3333'3333;
+		}
+
+		/// @brief Converts 8 ASCII digits loaded as a little-endian word, by combining pairs of digits, then pairs of
+		/// pairs, then pairs of quadruples with three multiplications.
+		inline std::uint32_t parse_eight_digits(std::uint64_t a_chars)
+		{
+			a_chars -= 0x3030'3030'3030'3030;
+			a_chars = (a_chars * 10 + (a_chars >> 8)) & 0x00FF'00FF'00FF'00FF;
+			a_chars = (a_chars * 100 + (a_chars >> 16)) & 0x0000'FFFF'0000'FFFF;
+			return static_cast<std::uint32_t>((a_chars * 10000 + (a_chars >> 32)) & 0xFFFF'FFFF);
+		}
+
+		/// @brief Consumes digits, accumulating them in a mantissa as long as it cannot overflow.
+		/// Returns the number of digits consumed.
+		inline std::size_t consume_json_digits(
+			char const*& a_current,
+			char const* const a_last,
+			std::uint64_t& a_mantissa,
+			std::size_t& a_mantissaDigitCount)
+		{
+			// A mantissa of 19 digits always fits 64 bits
+			constexpr std::size_t maxMantissaDigitCount = 19;
+
+			auto const first = a_current;
+			if constexpr (std::endian::native == std::endian::little)
+			{
+				while (a_last - a_current >= 8 && a_mantissaDigitCount + 8 <= maxMantissaDigitCount)
+				{
+					std::uint64_t chars;
+					std::memcpy(&chars, a_current, sizeof(chars));
+					if (!is_eight_digits(chars))
+					{
+						break;
+					}
+					a_mantissa = a_mantissa * 100'000'000 + parse_eight_digits(chars);
+					a_mantissaDigitCount += 8;
+					a_current += 8;
+				}
+			}
+			while (a_current != a_last && *a_current >= '0' && *a_current <= '9')
+			{
+				if (a_mantissaDigitCount < maxMantissaDigitCount)
+				{
+					a_mantissa = a_mantissa * 10 + static_cast<std::uint64_t>(*a_current - '0');
+				}
+				++a_mantissaDigitCount;
+				++a_current;
+			}
+			return static_cast<std::size_t>(a_current - first);
+		}
+
+		/// @brief Computes mantissa * 10^exponent when the mantissa and power of ten are both exact doubles, in which
+		/// case a single rounded operation gives the correctly rounded result (Clinger's fast path).
+		inline bool compute_json_double_fast(std::uint64_t a_mantissa, std::int64_t a_exponent, double& a_value)
+		{
+			constexpr double powersOfTen[] = {
+				1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+				1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+			};
+			constexpr std::uint64_t maxExactMantissa = std::uint64_t{ 1 } << 53;
+			constexpr std::int64_t maxExactExponent = 22;
+
+			if (a_mantissa > maxExactMantissa)
+			{
+				return false;
+			}
+
+			// Small mantissas can absorb part of a larger exponent while staying exact
+			while (a_exponent > maxExactExponent && a_mantissa <= maxExactMantissa / 10)
+			{
+				a_mantissa *= 10;
+				--a_exponent;
+			}
+			if (a_exponent < -maxExactExponent || a_exponent > maxExactExponent)
+			{
+				return false;
+			}
+
+			a_value = static_cast<double>(a_mantissa);
+			if (a_exponent < 0)
+			{
+				a_value /= powersOfTen[-a_exponent];
+			}
+			else
+			{
+				a_value *= powersOfTen[a_exponent];
+			}
+			return true;
+		}
+
+		/// @brief Provides the decimal exponent of the first non-zero digit of a number's mantissa, e.g. 2 for
+		/// "123.4" and -3 for "0.0012", the mantissa being text matching -?[0-9]+(\.[0-9]+)? with a non-zero digit.
+		inline std::int64_t get_json_leading_exponent(char const* a_current, char const* const a_last)
+		{
+			if (a_current != a_last && *a_current == '-')
+			{
+				++a_current;
+			}
+			while (a_current != a_last && *a_current == '0')
+			{
+				++a_current;
+			}
+			std::int64_t integerDigitCount = 0;
+			while (a_current != a_last && *a_current >= '0' && *a_current <= '9')
+			{
+				++integerDigitCount;
+				++a_current;
+			}
+			if (integerDigitCount != 0)
+			{
+				return integerDigitCount - 1;
+			}
+
+			// Only zeros before the point, so the first non-zero digit is in the fraction
+			std::int64_t leadingZeroCount = 0;
+			for (++a_current; a_current != a_last && *a_current == '0'; ++a_current)
+			{
+				++leadingZeroCount;
+			}
+			return -leadingZeroCount - 1;
+		}
+
+		/// @brief Parses a JSON number, advancing current past it: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+		/// Numbers with a fraction or exponent are stored as TFloat, other ones as int64 when negative and uint64
+		/// otherwise, or as TFloat if they do not fit.
+		/// Conversions are exact and do not depend on the locale: doubles of up to 19 significant digits with a
+		/// small exponent are computed directly, other numbers are converted with std::from_chars.
+		template <typename TFloat>
+		bool parse_json_number(
+			char const*& a_current,
+			char const* const a_last,
+			std::variant<std::int64_t, std::uint64_t, TFloat>& a_value)
+		{
+			auto const first = a_current;
+			auto const consume = [&a_current, a_last](char const a_char)
+			{
+				if (a_current == a_last || *a_current != a_char)
+				{
+					return false;
+				}
+				++a_current;
+				return true;
+			};
+
+			std::uint64_t mantissa = 0;
+			std::size_t mantissaDigitCount = 0;
+			auto const isNegative = consume('-');
+			if (!consume('0') && consume_json_digits(a_current, a_last, mantissa, mantissaDigitCount) == 0)
+			{
+				return false;
+			}
+
+			std::size_t fractionDigitCount = 0;
+			auto const hasFraction = consume('.');
+			if (hasFraction)
+			{
+				fractionDigitCount = consume_json_digits(a_current, a_last, mantissa, mantissaDigitCount);
+				if (fractionDigitCount == 0)
+				{
+					return false;
+				}
+			}
+
+			auto const mantissaLast = a_current;
+			std::int64_t exponent = 0;
+			auto const hasExponent = consume('e') || consume('E');
+			if (hasExponent)
+			{
+				auto const isExponentNegative = consume('-');
+				if (!isExponentNegative)
+				{
+					consume('+');
+				}
+				auto const exponentFirst = a_current;
+				while (a_current != a_last && *a_current >= '0' && *a_current <= '9')
+				{
+					// Larger exponents saturate, their value is zero or infinite anyway
+					if (exponent < 100'000)
+					{
+						exponent = exponent * 10 + (*a_current - '0');
+					}
+					++a_current;
+				}
+				if (a_current == exponentFirst)
+				{
+					return false;
+				}
+				exponent = isExponentNegative ? -exponent : exponent;
+			}
+
+			constexpr std::size_t maxMantissaDigitCount = 19;
+			if (!hasFraction && !hasExponent && mantissaDigitCount <= maxMantissaDigitCount)
+			{
+				if (!isNegative)
+				{
+					a_value = mantissa;
+					return true;
+				}
+				if (mantissa <= std::uint64_t{ 1 } << 63)
+				{
+					a_value = static_cast<std::int64_t>(0 - mantissa);
+					return true;
+				}
+			}
+			else if (!hasFraction && !hasExponent)
+			{
+				std::uint64_t value;
+				if (!isNegative && std::from_chars(first, a_current, value).ec == std::errc{})
+				{
+					a_value = value;
+					return true;
+				}
+			}
+
+			if constexpr (std::is_same_v<TFloat, double>)
+			{
+				double value;
+				auto const exponent10 = exponent - static_cast<std::int64_t>(fractionDigitCount);
+				if (mantissaDigitCount <= maxMantissaDigitCount && compute_json_double_fast(mantissa, exponent10, value))
+				{
+					a_value = isNegative ? -value : value;
+					return true;
+				}
+			}
+
+			// Out of range values are still valid JSON, from_chars reports them but sets nothing
+			TFloat value;
+			auto const result = std::from_chars(first, a_current, value);
+			if (result.ec == std::errc::result_out_of_range)
+			{
+				// The value is tiny if its first non-zero digit comes after the point, whatever the digits count
+				auto const isTiny = get_json_leading_exponent(first, mantissaLast) + exponent < 0;
+				value = isTiny ? TFloat{ 0 } : std::numeric_limits<TFloat>::infinity();
+				value = isNegative ? -value : value;
+			}
+			else if (result.ec != std::errc{} || result.ptr != a_current)
+			{
+				return false;
+			}
+			a_value = value;
+			return true;
+		}
+	}
+}
@@ -0,0 +1,614 @@
+#pragma once
+
+#include "json.h"
+#include "json_number_parser.h"
+#include "json_structural_index.h"
+
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <variant>
+
+
+namespace vob::mistd
+{
+	namespace detail
+	{
+		/// @brief Parses JSON from a contiguous buffer, walking raw pointers rather than going through a stream.
+		template <typename TAllocator>
+		class basic_json_buffer_parser
+		{
+		public:
+#pragma region TYPES
+			using value_type = basic_json_value<TAllocator>;
+			using string_type = std::basic_string<char, std::char_traits<char>, TAllocator>;
+#pragma endregion
+
+#pragma region CREATORS
+			/// @brief Creates a parser reading [first, last).
+			basic_json_buffer_parser(char const* a_first, char const* a_last)
+				: m_current{ a_first }
+				, m_last{ a_last }
+			{}
+#pragma endregion
+
+#pragma region ACCESSORS
+			/// @brief Provides where parsing stopped: after the parsed value, or where an error was found.
+			[[nodiscard]] auto get_current() const
+			{
+				return m_current;
+			}
+#pragma endregion
+
+#pragma region MANIPULATORS
+			/// @brief Parses a value, skipping the whitespaces before it.
+			bool parse_value(value_type& a_value)
+			{
+				skip_whitespaces();
+				if (m_current == m_last)
+				{
+					return false;
+				}
+
+				switch (*m_current)
+				{
+				case '"':
+				{
+					auto& string = a_value.template set<basic_json_string<TAllocator>>(a_value.get_allocator());
+					return parse_string(string.value);
+				}
+				case '{':
+				{
+					auto& object = a_value.template set<basic_json_object<TAllocator>>(a_value.get_allocator());
+					return parse_object(object);
+				}
+				case '[':
+				{
+					auto& array = a_value.template set<basic_json_array<TAllocator>>(a_value.get_allocator());
+					return parse_array(array);
+				}
+				case 't':
+				{
+					a_value.template set<basic_json_boolean<TAllocator>>(true);
+					return parse_literal("true");
+				}
+				case 'f':
+				{
+					a_value.template set<basic_json_boolean<TAllocator>>(false);
+					return parse_literal("false");
+				}
+				case 'n':
+				{
+					a_value.template set<basic_json_null<TAllocator>>();
+					return parse_literal("null");
+				}
+				default:
+				{
+					auto& number = a_value.template set<basic_json_number<TAllocator>>();
+					return parse_json_number(m_current, m_last, number.value);
+				}
+				}
+			}
+
+			/// @brief Parses a string starting at its opening quote, decoding escape sequences.
+			bool parse_string(string_type& a_string)
+			{
+				if (!consume('"'))
+				{
+					return false;
+				}
+
+				// Characters are appended by runs between escape sequences
+				auto runStart = m_current;
+				while (m_current != m_last)
+				{
+					auto const c = *m_current;
+					if (c == '"')
+					{
+						a_string.append(runStart, m_current);
+						++m_current;
+						return true;
+					}
+					if (c == '\\')
+					{
+						a_string.append(runStart, m_current);
+						++m_current;
+						if (!parse_escape(a_string))
+						{
+							return false;
+						}
+						runStart = m_current;
+					}
+					else if (static_cast<unsigned char>(c) < 0x20)
+					{
+						return false;
+					}
+					else
+					{
+						++m_current;
+					}
+				}
+				return false;
+			}
+#pragma endregion
+
+		private:
+#pragma region PRIVATE_DATA
+			char const* m_current;
+			char const* m_last;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+			void skip_whitespaces()
+			{
+				while (m_current != m_last
+					&& (*m_current == ' ' || *m_current == '\n' || *m_current == '\r' || *m_current == '\t'))
+				{
+					++m_current;
+				}
+			}
+
+			bool consume(char const a_char)
+			{
+				if (m_current == m_last || *m_current != a_char)
+				{
+					return false;
+				}
+				++m_current;
+				return true;
+			}
+
+			bool parse_literal(std::string_view const a_literal)
+			{
+				if (static_cast<std::size_t>(m_last - m_current) < a_literal.size()
+					|| std::string_view{ m_current, a_literal.size() } != a_literal)
+				{
+					return false;
+				}
+				m_current += a_literal.size();
+				return true;
+			}
+
+			bool parse_hex4(std::uint32_t& a_codeUnit)
+			{
+				if (m_last - m_current < 4)
+				{
+					return false;
+				}
+				auto const result = std::from_chars(m_current, m_current + 4, a_codeUnit, 16);
+				if (result.ptr != m_current + 4)
+				{
+					return false;
+				}
+				m_current += 4;
+				return true;
+			}
+
+			void append_utf8(string_type& a_string, std::uint32_t const a_codePoint)
+			{
+				if (a_codePoint < 0x80)
+				{
+					a_string.push_back(static_cast<char>(a_codePoint));
+				}
+				else if (a_codePoint < 0x800)
+				{
+					a_string.push_back(static_cast<char>(0xC0 | (a_codePoint >> 6)));
+					a_string.push_back(static_cast<char>(0x80 | (a_codePoint & 0x3F)));
+				}
+				else if (a_codePoint < 0x10000)
+				{
+					a_string.push_back(static_cast<char>(0xE0 | (a_codePoint >> 12)));
+					a_string.push_back(static_cast<char>(0x80 | ((a_codePoint >> 6) & 0x3F)));
+					a_string.push_back(static_cast<char>(0x80 | (a_codePoint & 0x3F)));
+				}
+				else
+				{
+					a_string.push_back(static_cast<char>(0xF0 | (a_codePoint >> 18)));
+					a_string.push_back(static_cast<char>(0x80 | ((a_codePoint >> 12) & 0x3F)));
+					a_string.push_back(static_cast<char>(0x80 | ((a_codePoint >> 6) & 0x3F)));
+					a_string.push_back(static_cast<char>(0x80 | (a_codePoint & 0x3F)));
+				}
+			}
+
+			bool parse_escape(string_type& a_string)
+			{
+				if (m_current == m_last)
+				{
+					return false;
+				}
+				switch (*m_current++)
+				{
+				case '"': a_string.push_back('"'); return true;
+				case '\\': a_string.push_back('\\'); return true;
+				case '/': a_string.push_back('/'); return true;
+				case 'b': a_string.push_back('\b'); return true;
+				case 'f': a_string.push_back('\f'); return true;
+				case 'n': a_string.push_back('\n'); return true;
+				case 'r': a_string.push_back('\r'); return true;
+				case 't': a_string.push_back('\t'); return true;
+				case 'u':
+				{
+					std::uint32_t codePoint;
+					if (!parse_hex4(codePoint))
+					{
+						return false;
+					}
+					// Characters outside the basic multilingual plane are escaped as a surrogate pair
+					if (codePoint >= 0xD800 && codePoint < 0xDC00)
+					{
+						std::uint32_t lowSurrogate;
+						if (!consume('\\') || !consume('u') || !parse_hex4(lowSurrogate)
+							|| lowSurrogate < 0xDC00 || lowSurrogate >= 0xE000)
+						{
+							return false;
+						}
+						codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+					}
+					append_utf8(a_string, codePoint);
+					return true;
+				}
+				default:
+					return false;
+				}
+			}
+
+			bool parse_object(basic_json_object<TAllocator>& a_object)
+			{
+				++m_current;
+				skip_whitespaces();
+				if (consume('}'))
+				{
+					return true;
+				}
+
+				TAllocator const allocator{ a_object.data.get_allocator() };
+				while (true)
+				{
+					skip_whitespaces();
+					string_type key{ allocator };
+					if (!parse_string(key))
+					{
+						return false;
+					}
+					skip_whitespaces();
+					if (!consume(':'))
+					{
+						return false;
+					}
+					value_type value{ allocator };
+					if (!parse_value(value))
+					{
+						return false;
+					}
+					a_object.data.emplace(std::move(key), std::move(value));
+
+					skip_whitespaces();
+					if (consume('}'))
+					{
+						return true;
+					}
+					if (!consume(','))
+					{
+						return false;
+					}
+				}
+			}
+
+			bool parse_array(basic_json_array<TAllocator>& a_array)
+			{
+				++m_current;
+				skip_whitespaces();
+				if (consume(']'))
+				{
+					return true;
+				}
+
+				TAllocator const allocator{ a_array.data.get_allocator() };
+				while (true)
+				{
+					auto& value = a_array.data.emplace_back(allocator);
+					if (!parse_value(value))
+					{
+						return false;
+					}
+
+					skip_whitespaces();
+					if (consume(']'))
+					{
+						return true;
+					}
+					if (!consume(','))
+					{
+						return false;
+					}
+				}
+			}
+#pragma endregion
+		};
+
+		/// @brief Documents from this size are parsed in two stages, below it indexing costs more than it saves.
+		inline constexpr std::size_t json_indexed_parse_threshold = 1 << 16;
+
+		/// @brief Second stage of a two-stage JSON parse: builds values by walking the positions of a structural index
+		/// rather than every byte. Numbers, literals and strings with escape sequences are handed to the buffer
+		/// parser, other strings are copied in one go since their closing quote is known.
+		template <typename TAllocator>
+		class basic_json_indexed_parser
+		{
+		public:
+#pragma region TYPES
+			using value_type = basic_json_value<TAllocator>;
+			using string_type = std::basic_string<char, std::char_traits<char>, TAllocator>;
+#pragma endregion
+
+#pragma region CREATORS
+			/// @brief Creates a parser reading [first, last), whose structural characters are at the given positions.
+			basic_json_indexed_parser(
+				char const* a_first,
+				char const* a_last,
+				std::span<std::uint32_t const> a_positions,
+				std::size_t a_firstControlPosition)
+				: m_first{ a_first }
+				, m_last{ a_last }
+				, m_current{ a_first }
+				, m_positions{ a_positions }
+				, m_firstControlPosition{ a_firstControlPosition }
+			{}
+#pragma endregion
+
+#pragma region ACCESSORS
+			/// @brief Provides where parsing stopped: after the parsed value, or where an error was found.
+			[[nodiscard]] auto get_current() const
+			{
+				return m_current;
+			}
+#pragma endregion
+
+#pragma region MANIPULATORS
+			/// @brief Parses the value starting at the next structural character.
+			bool parse_value(value_type& a_value)
+			{
+				auto const token = next_token();
+				if (token == m_last)
+				{
+					m_current = m_last;
+					return false;
+				}
+				m_current = token;
+
+				switch (*token)
+				{
+				case '"':
+				{
+					auto& string = a_value.template set<basic_json_string<TAllocator>>(a_value.get_allocator());
+					return parse_string(token, string.value);
+				}
+				case '{':
+				{
+					auto& object = a_value.template set<basic_json_object<TAllocator>>(a_value.get_allocator());
+					return parse_object(object);
+				}
+				case '[':
+				{
+					auto& array = a_value.template set<basic_json_array<TAllocator>>(a_value.get_allocator());
+					return parse_array(array);
+				}
+				default:
+				{
+					basic_json_buffer_parser<TAllocator> parser{ token, m_last };
+					auto const isValid = parser.parse_value(a_value);
+					m_current = parser.get_current();
+					return isValid;
+				}
+				}
+			}
+#pragma endregion
+
+		private:
+#pragma region PRIVATE_DATA
+			char const* m_first;
+			char const* m_last;
+			char const* m_current;
+			std::span<std::uint32_t const> m_positions;
+			std::size_t m_nextPosition = 0;
+			std::size_t m_firstControlPosition;
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+			[[nodiscard]] char const* peek_token() const
+			{
+				return m_nextPosition < m_positions.size() ? m_first + m_positions[m_nextPosition] : m_last;
+			}
+
+			/// @brief Whether only whitespaces separate the end of the last value from the next structural character.
+			/// Numbers and literals are not delimited by the index, so trailing characters are only found here.
+			[[nodiscard]] bool is_followed_by_whitespaces() const
+			{
+				auto const token = peek_token();
+				for (auto current = m_current; current != token; ++current)
+				{
+					if (*current != ' ' && *current != '\n' && *current != '\r' && *current != '\t')
+					{
+						return false;
+					}
+				}
+				return true;
+			}
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+			char const* next_token()
+			{
+				auto const token = peek_token();
+				m_nextPosition += token != m_last;
+				return token;
+			}
+
+			bool consume(char const a_char)
+			{
+				auto const token = peek_token();
+				if (token == m_last || *token != a_char)
+				{
+					m_current = token;
+					return false;
+				}
+				++m_nextPosition;
+				m_current = token + 1;
+				return true;
+			}
+
+			bool parse_string(char const* const a_openingQuote, string_type& a_string)
+			{
+				// Nothing inside a string is structural, so the next position is its closing quote
+				auto const closingQuote = next_token();
+				if (closingQuote == m_last)
+				{
+					m_current = m_last;
+					return false;
+				}
+				auto const openingPosition = static_cast<std::size_t>(a_openingQuote - m_first);
+				auto const closingPosition = static_cast<std::size_t>(closingQuote - m_first);
+				if (openingPosition < m_firstControlPosition && m_firstControlPosition < closingPosition)
+				{
+					m_current = m_first + m_firstControlPosition;
+					return false;
+				}
+
+				auto const first = a_openingQuote + 1;
+				auto const size = static_cast<std::size_t>(closingQuote - first);
+				if (std::memchr(first, '\\', size) == nullptr)
+				{
+					a_string.assign(first, size);
+				}
+				else
+				{
+					basic_json_buffer_parser<TAllocator> parser{ a_openingQuote, m_last };
+					if (!parser.parse_string(a_string))
+					{
+						m_current = parser.get_current();
+						return false;
+					}
+				}
+				m_current = closingQuote + 1;
+				return true;
+			}
+
+			bool parse_object(basic_json_object<TAllocator>& a_object)
+			{
+				m_current = m_current + 1;
+				if (consume('}'))
+				{
+					return true;
+				}
+
+				TAllocator const allocator{ a_object.data.get_allocator() };
+				while (true)
+				{
+					auto const keyToken = peek_token();
+					if (keyToken == m_last || *keyToken != '"')
+					{
+						m_current = keyToken;
+						return false;
+					}
+					++m_nextPosition;
+					string_type key{ allocator };
+					if (!parse_string(keyToken, key) || !consume(':'))
+					{
+						return false;
+					}
+					value_type value{ allocator };
+					if (!parse_value(value) || !is_followed_by_whitespaces())
+					{
+						return false;
+					}
+					a_object.data.emplace(std::move(key), std::move(value));
+
+					if (consume('}'))
+					{
+						return true;
+					}
+					if (!consume(','))
+					{
+						return false;
+					}
+				}
+			}
+
+			bool parse_array(basic_json_array<TAllocator>& a_array)
+			{
+				m_current = m_current + 1;
+				if (consume(']'))
+				{
+					return true;
+				}
+
+				TAllocator const allocator{ a_array.data.get_allocator() };
+				while (true)
+				{
+					auto& value = a_array.data.emplace_back(allocator);
+					if (!parse_value(value) || !is_followed_by_whitespaces())
+					{
+						return false;
+					}
+
+					if (consume(']'))
+					{
+						return true;
+					}
+					if (!consume(','))
+					{
+						return false;
+					}
+				}
+			}
+#pragma endregion
+		};
+	}
+
+	/// @brief Parses a JSON value from [first, last) in two stages, reusing the given index for the first one.
+	/// Results are the same as the single-stage overload.
+	template <typename TAllocator, typename TIndexAllocator>
+	std::from_chars_result parse_json(
+		char const* const a_first,
+		char const* const a_last,
+		basic_json_value<TAllocator>& a_value,
+		basic_json_structural_index<TIndexAllocator>& a_index)
+	{
+		a_index.build(a_first, a_last);
+		detail::basic_json_indexed_parser<TAllocator> parser{
+			a_first, a_last, a_index.get_positions(), a_index.get_first_control_position() };
+		auto const isValid = parser.parse_value(a_value);
+		return { parser.get_current(), isValid ? std::errc{} : std::errc::invalid_argument };
+	}
+
+	/// @brief Parses a JSON value from [first, last), skipping the whitespaces before it.
+	/// On success, the returned pointer is right after the value. On failure, it is where the error was found and
+	/// the error code is std::errc::invalid_argument.
+	/// Large documents are parsed in two stages, see basic_json_structural_index.
+	template <typename TAllocator>
+	std::from_chars_result parse_json(
+		char const* const a_first,
+		char const* const a_last,
+		basic_json_value<TAllocator>& a_value)
+	{
+		if (static_cast<std::size_t>(a_last - a_first) >= detail::json_indexed_parse_threshold)
+		{
+			json_structural_index index;
+			return parse_json(a_first, a_last, a_value, index);
+		}
+
+		detail::basic_json_buffer_parser<TAllocator> parser{ a_first, a_last };
+		auto const isValid = parser.parse_value(a_value);
+		return { parser.get_current(), isValid ? std::errc{} : std::errc::invalid_argument };
+	}
+
+	/// @brief Parses a JSON value from a string, see the pointer overload.
+	template <typename TAllocator>
+	std::from_chars_result parse_json(std::string_view const a_input, basic_json_value<TAllocator>& a_value)
+	{
+		return parse_json(a_input.data(), a_input.data() + a_input.size(), a_value);
+	}
+}
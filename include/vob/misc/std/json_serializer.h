@@ -0,0 +1,457 @@
+#pragma once
+
+#include "json.h"
+#include "json_structural_index.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <variant>
+
+
+namespace vob::mistd
+{
+	/// @brief How a basic_json_serializer lays out what it writes.
+	enum class json_format
+	{
+		/// @brief No whitespace at all.
+		compact,
+		/// @brief One member or element per line, indented with a tab per level.
+		pretty
+	};
+
+	/// @brief Sink appending to a growable buffer, such as a std::string or std::vector<char>.
+	template <typename TBuffer>
+	class json_buffer_sink
+	{
+	public:
+#pragma region CREATORS
+		explicit json_buffer_sink(TBuffer& a_buffer)
+			: m_buffer{ a_buffer }
+		{}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		void operator()(char const* const a_data, std::size_t const a_size)
+		{
+			m_buffer.insert(m_buffer.end(), a_data, a_data + a_size);
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		TBuffer& m_buffer;
+#pragma endregion
+	};
+
+	/// @brief Sink writing to a stream.
+	class json_ostream_sink
+	{
+	public:
+#pragma region CREATORS
+		explicit json_ostream_sink(std::ostream& a_outputStream)
+			: m_outputStream{ a_outputStream }
+		{}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		void operator()(char const* const a_data, std::size_t const a_size)
+		{
+			m_outputStream.write(a_data, static_cast<std::streamsize>(a_size));
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		std::ostream& m_outputStream;
+#pragma endregion
+	};
+
+	namespace detail
+	{
+		/// @brief Provides the size of the longest prefix of [first, last) that can be written in a JSON string as is.
+		inline std::size_t find_json_escape_scalar(char const* const a_first, char const* const a_last)
+		{
+			auto current = a_first;
+			while (current != a_last)
+			{
+				auto const c = static_cast<unsigned char>(*current);
+				if (c < 0x20 || c == '"' || c == '\\')
+				{
+					break;
+				}
+				++current;
+			}
+			return static_cast<std::size_t>(current - a_first);
+		}
+
+		/// @brief Provides the size of the longest prefix of [first, last) that can be written in a JSON string as is,
+		/// testing 16 characters at a time.
+		inline std::size_t find_json_escape(char const* const a_first, char const* const a_last)
+		{
+#ifdef VOB_MISTD_JSON_X64
+			auto current = a_first;
+			while (a_last - current >= 16)
+			{
+				auto const chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(current));
+				// Unsigned chars below 0x20 are the ones left unchanged by a maximum with 0x1F
+				auto const controls = _mm_cmpeq_epi8(_mm_max_epu8(chars, _mm_set1_epi8(0x1F)), _mm_set1_epi8(0x1F));
+				auto const escaped = _mm_or_si128(
+					controls,
+					_mm_or_si128(
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')),
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8('\\'))));
+				auto const mask = static_cast<unsigned>(_mm_movemask_epi8(escaped));
+				if (mask != 0)
+				{
+					return static_cast<std::size_t>(current - a_first) + std::countr_zero(mask);
+				}
+				current += 16;
+			}
+			return static_cast<std::size_t>(current - a_first) + find_json_escape_scalar(current, a_last);
+#else
+			return find_json_escape_scalar(a_first, a_last);
+#endif
+		}
+	}
+
+	/// @brief Writes JSON to a sink, called as void(char const* data, std::size_t size), through a fixed size buffer
+	/// so the sink is called with large chunks.
+	/// Values are written whole from a basic_json_value, or piece by piece: objects and arrays are started and ended
+	/// around their content, and members are written as a key followed by a value. Separators and indentation are
+	/// written as needed.
+	/// Numbers are written with std::to_chars, in the shortest form that reads back to the same value. Floating
+	/// numbers with an integral value keep a ".0" so they read back as floating numbers, and infinities and NaNs,
+	/// which JSON cannot represent, are written as null.
+	template <typename TSink>
+	class basic_json_serializer
+	{
+	public:
+#pragma region CREATORS
+		explicit basic_json_serializer(TSink a_sink, json_format const a_format = json_format::compact)
+			: m_sink{ std::move(a_sink) }
+			, m_format{ a_format }
+		{}
+
+		basic_json_serializer(basic_json_serializer const&) = delete;
+		basic_json_serializer(basic_json_serializer&&) = delete;
+
+		~basic_json_serializer()
+		{
+			flush();
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		basic_json_serializer& operator=(basic_json_serializer const&) = delete;
+		basic_json_serializer& operator=(basic_json_serializer&&) = delete;
+
+		/// @brief Writes a value.
+		template <typename TAllocator>
+		void write(basic_json_value<TAllocator> const& a_value)
+		{
+			if (auto const boolean = a_value.template get<basic_json_boolean<TAllocator>>())
+			{
+				write_boolean(boolean->value);
+			}
+			else if (auto const number = a_value.template get<basic_json_number<TAllocator>>())
+			{
+				std::visit([this](auto const a_number) { write_number(a_number); }, number->value);
+			}
+			else if (auto const string = a_value.template get<basic_json_string<TAllocator>>())
+			{
+				write_string(string->value);
+			}
+			else if (auto const array = a_value.template get<basic_json_array<TAllocator>>())
+			{
+				start_array();
+				for (auto const& element : array->data)
+				{
+					write(element);
+				}
+				end_array();
+			}
+			else if (auto const object = a_value.template get<basic_json_object<TAllocator>>())
+			{
+				start_object();
+				for (auto const& [key, member] : object->data)
+				{
+					write_key(key.view());
+					write(member);
+				}
+				end_object();
+			}
+			else
+			{
+				write_null();
+			}
+		}
+
+		/// @brief Starts an object, whose members are written with write_key followed by their value.
+		void start_object()
+		{
+			start_container('{');
+		}
+
+		void end_object()
+		{
+			end_container('}');
+		}
+
+		/// @brief Starts an array, whose elements are written as values.
+		void start_array()
+		{
+			start_container('[');
+		}
+
+		void end_array()
+		{
+			end_container(']');
+		}
+
+		/// @brief Writes the key of the next member of the current object.
+		void write_key(std::string_view const a_key)
+		{
+			write_separator();
+			write_quoted(a_key);
+			write_raw(m_format == json_format::pretty ? ": " : ":");
+			m_isAfterKey = true;
+		}
+
+		void write_null()
+		{
+			write_separator();
+			write_raw("null");
+		}
+
+		void write_boolean(bool const a_boolean)
+		{
+			write_separator();
+			write_raw(a_boolean ? "true" : "false");
+		}
+
+		template <typename TNumber>
+		requires std::is_arithmetic_v<TNumber> && (!std::is_same_v<TNumber, bool>)
+		void write_number(TNumber const a_number)
+		{
+			// Longest shortest representation of a long double, with room for a ".0" suffix
+			constexpr std::size_t maxSize = 64;
+
+			write_separator();
+			if constexpr (std::is_floating_point_v<TNumber>)
+			{
+				if (!std::isfinite(a_number))
+				{
+					write_raw("null");
+					return;
+				}
+			}
+
+			auto const first = reserve(maxSize);
+			auto const last = std::to_chars(first, first + maxSize, a_number).ptr;
+			m_size += static_cast<std::size_t>(last - first);
+			if constexpr (std::is_floating_point_v<TNumber>)
+			{
+				if (std::find_if(first, last, [](char const a_c) { return a_c == '.' || a_c == 'e'; }) == last)
+				{
+					write_raw(".0");
+				}
+			}
+		}
+
+		void write_string(std::string_view const a_string)
+		{
+			write_separator();
+			write_quoted(a_string);
+		}
+
+		/// @brief Passes everything written so far to the sink.
+		void flush()
+		{
+			if (m_size != 0)
+			{
+				m_sink(m_chunk.data(), m_size);
+				m_size = 0;
+			}
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		/// @brief Room for the longest number or escape sequence, so those can be written in place.
+		constexpr static std::size_t s_chunkSize = 1 << 12;
+
+		TSink m_sink;
+		json_format m_format;
+		/// @brief Number of objects and arrays started and not ended.
+		std::size_t m_depth = 0;
+		/// @brief Whether nothing was written in the current object or array yet.
+		bool m_isFirst = false;
+		/// @brief Whether a key was just written, so the next value needs no separator.
+		bool m_isAfterKey = false;
+		std::size_t m_size = 0;
+		std::array<char, s_chunkSize> m_chunk;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		/// @brief Makes room for a_size characters in the chunk, which must be at most its size.
+		char* reserve(std::size_t const a_size)
+		{
+			if (s_chunkSize - m_size < a_size)
+			{
+				flush();
+			}
+			return m_chunk.data() + m_size;
+		}
+
+		void write_raw(std::string_view const a_text)
+		{
+			if (a_text.size() > s_chunkSize - m_size)
+			{
+				flush();
+				if (a_text.size() > s_chunkSize)
+				{
+					m_sink(a_text.data(), a_text.size());
+					return;
+				}
+			}
+			std::memcpy(m_chunk.data() + m_size, a_text.data(), a_text.size());
+			m_size += a_text.size();
+		}
+
+		void write_character(char const a_character)
+		{
+			*reserve(1) = a_character;
+			++m_size;
+		}
+
+		/// @brief Starts a new line at the current depth.
+		void write_indentation()
+		{
+			write_character('\n');
+			for (auto i = std::size_t{ 0 }; i < m_depth; ++i)
+			{
+				write_character('\t');
+			}
+		}
+
+		/// @brief Writes what comes before a value or key: nothing after a key or at the top level, otherwise a comma
+		/// if it is not the first of its object or array, then a new line in pretty format.
+		void write_separator()
+		{
+			if (m_isAfterKey)
+			{
+				m_isAfterKey = false;
+				return;
+			}
+			if (m_depth == 0)
+			{
+				return;
+			}
+			if (!m_isFirst)
+			{
+				write_character(',');
+			}
+			m_isFirst = false;
+			if (m_format == json_format::pretty)
+			{
+				write_indentation();
+			}
+		}
+
+		void start_container(char const a_start)
+		{
+			write_separator();
+			write_character(a_start);
+			++m_depth;
+			m_isFirst = true;
+		}
+
+		void end_container(char const a_end)
+		{
+			--m_depth;
+			if (!m_isFirst && m_format == json_format::pretty)
+			{
+				write_indentation();
+			}
+			write_character(a_end);
+			m_isFirst = false;
+		}
+
+		void write_quoted(std::string_view a_string)
+		{
+			constexpr char hexDigits[] = "0123456789abcdef";
+
+			write_character('"');
+			while (!a_string.empty())
+			{
+				auto const runSize = detail::find_json_escape(a_string.data(), a_string.data() + a_string.size());
+				write_raw(a_string.substr(0, runSize));
+				if (runSize == a_string.size())
+				{
+					break;
+				}
+
+				auto const c = static_cast<unsigned char>(a_string[runSize]);
+				switch (c)
+				{
+				case '"': write_raw("\\\""); break;
+				case '\\': write_raw("\\\\"); break;
+				case '\b': write_raw("\\b"); break;
+				case '\f': write_raw("\\f"); break;
+				case '\n': write_raw("\\n"); break;
+				case '\r': write_raw("\\r"); break;
+				case '\t': write_raw("\\t"); break;
+				default:
+				{
+					char const escape[] = { '\\', 'u', '0', '0', hexDigits[c >> 4], hexDigits[c & 0xF] };
+					write_raw({ escape, sizeof(escape) });
+					break;
+				}
+				}
+				a_string.remove_prefix(runSize + 1);
+			}
+			write_character('"');
+		}
+#pragma endregion
+	};
+
+	/// @brief Appends the JSON text of a value to a growable buffer, such as a std::string or std::vector<char>.
+	template <typename TAllocator, typename TBuffer>
+	requires requires(TBuffer& a_buffer, char const* a_data) { a_buffer.insert(a_buffer.end(), a_data, a_data); }
+	void serialize_json(
+		basic_json_value<TAllocator> const& a_value,
+		TBuffer& a_buffer,
+		json_format const a_format = json_format::compact)
+	{
+		basic_json_serializer<json_buffer_sink<TBuffer>> serializer{ json_buffer_sink<TBuffer>{ a_buffer }, a_format };
+		serializer.write(a_value);
+	}
+
+	/// @brief Writes the JSON text of a value to a stream.
+	template <typename TAllocator>
+	void serialize_json(
+		basic_json_value<TAllocator> const& a_value,
+		std::ostream& a_outputStream,
+		json_format const a_format = json_format::compact)
+	{
+		basic_json_serializer<json_ostream_sink> serializer{ json_ostream_sink{ a_outputStream }, a_format };
+		serializer.write(a_value);
+	}
+
+	/// @brief Writes the compact JSON text of a value to a stream.
+	template <typename TAllocator>
+	std::ostream& operator<<(std::ostream& a_outputStream, basic_json_value<TAllocator> const& a_value)
+	{
+		serialize_json(a_value, a_outputStream);
+		return a_outputStream;
+	}
+}
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <span>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#	define VOB_MISTD_JSON_X64
+#	include <immintrin.h>
+#	if defined(_MSC_VER)
+#		include <intrin.h>
+#		define VOB_MISTD_JSON_TARGET_AVX2
+#	else
+#		define VOB_MISTD_JSON_TARGET_AVX2 __attribute__((target("avx2")))
+#	endif
+#endif
+
+
+namespace vob::mistd
+{
+	namespace detail
+	{
+		/// @brief One bit per byte of a 64 bytes block, for each class of characters the indexer cares about.
+		struct json_block_masks
+		{
+			std::uint64_t backslashes;
+			std::uint64_t quotes;
+			/// @brief {, }, [, ], : and ,
+			std::uint64_t operators;
+			std::uint64_t whitespaces;
+			/// @brief Characters below 0x20, which must be escaped in strings.
+			std::uint64_t controls;
+		};
+
+		using json_classify_function = json_block_masks (*)(char const*);
+
+		inline json_block_masks classify_json_block_scalar(char const* const a_block)
+		{
+			json_block_masks masks{};
+			for (auto i = 0u; i < 64; ++i)
+			{
+				auto const bit = std::uint64_t{ 1 } << i;
+				auto const c = static_cast<unsigned char>(a_block[i]);
+				switch (c)
+				{
+				case '\\': masks.backslashes |= bit; break;
+				case '"': masks.quotes |= bit; break;
+				case '{': case '}': case '[': case ']': case ':': case ',': masks.operators |= bit; break;
+				case ' ': masks.whitespaces |= bit; break;
+				case '\t': case '\n': case '\r': masks.whitespaces |= bit; masks.controls |= bit; break;
+				default: masks.controls |= c < 0x20 ? bit : 0; break;
+				}
+			}
+			return masks;
+		}
+
+#ifdef VOB_MISTD_JSON_X64
+		inline std::uint64_t get_sse2_mask(__m128i const a_bytes, unsigned const a_shift)
+		{
+			return std::uint64_t{ static_cast<std::uint16_t>(_mm_movemask_epi8(a_bytes)) } << a_shift;
+		}
+
+		inline json_block_masks classify_json_block_sse2(char const* const a_block)
+		{
+			json_block_masks masks{};
+			for (auto i = 0u; i < 4; ++i)
+			{
+				auto const chars = _mm_loadu_si128(reinterpret_cast<__m128i const*>(a_block + 16 * i));
+				// '[' and ']' only differ from '{' and '}' by the 0x20 bit
+				auto const lowered = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+				auto const operators = _mm_or_si128(
+					_mm_or_si128(
+						_mm_cmpeq_epi8(lowered, _mm_set1_epi8('{')),
+						_mm_cmpeq_epi8(lowered, _mm_set1_epi8('}'))),
+					_mm_or_si128(
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8(':')),
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8(','))));
+				auto const whitespaces = _mm_or_si128(
+					_mm_or_si128(
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8(' ')),
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8('\t'))),
+					_mm_or_si128(
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8('\n')),
+						_mm_cmpeq_epi8(chars, _mm_set1_epi8('\r'))));
+				auto const controls = _mm_cmpeq_epi8(_mm_min_epu8(chars, _mm_set1_epi8(0x1F)), chars);
+
+				auto const shift = 16 * i;
+				masks.backslashes |= get_sse2_mask(_mm_cmpeq_epi8(chars, _mm_set1_epi8('\\')), shift);
+				masks.quotes |= get_sse2_mask(_mm_cmpeq_epi8(chars, _mm_set1_epi8('"')), shift);
+				masks.operators |= get_sse2_mask(operators, shift);
+				masks.whitespaces |= get_sse2_mask(whitespaces, shift);
+				masks.controls |= get_sse2_mask(controls, shift);
+			}
+			return masks;
+		}
+
+		VOB_MISTD_JSON_TARGET_AVX2 inline std::uint64_t get_avx2_mask(__m256i const a_bytes, unsigned const a_shift)
+		{
+			return std::uint64_t{ static_cast<std::uint32_t>(_mm256_movemask_epi8(a_bytes)) } << a_shift;
+		}
+
+		VOB_MISTD_JSON_TARGET_AVX2 inline json_block_masks classify_json_block_avx2(char const* const a_block)
+		{
+			json_block_masks masks{};
+			for (auto i = 0u; i < 2; ++i)
+			{
+				auto const chars = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(a_block + 32 * i));
+				auto const lowered = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+				auto const operators = _mm256_or_si256(
+					_mm256_or_si256(
+						_mm256_cmpeq_epi8(lowered, _mm256_set1_epi8('{')),
+						_mm256_cmpeq_epi8(lowered, _mm256_set1_epi8('}'))),
+					_mm256_or_si256(
+						_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(':')),
+						_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(','))));
+				auto const whitespaces = _mm256_or_si256(
+					_mm256_or_si256(
+						_mm256_cmpeq_epi8(chars, _mm256_set1_epi8(' ')),
+						_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\t'))),
+					_mm256_or_si256(
+						_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\n')),
+						_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\r'))));
+				auto const controls = _mm256_cmpeq_epi8(_mm256_min_epu8(chars, _mm256_set1_epi8(0x1F)), chars);
+
+				auto const shift = 32 * i;
+				masks.backslashes |= get_avx2_mask(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('\\')), shift);
+				masks.quotes |= get_avx2_mask(_mm256_cmpeq_epi8(chars, _mm256_set1_epi8('"')), shift);
+				masks.operators |= get_avx2_mask(operators, shift);
+				masks.whitespaces |= get_avx2_mask(whitespaces, shift);
+				masks.controls |= get_avx2_mask(controls, shift);
+			}
+			return masks;
+		}
+
+		inline bool is_avx2_supported()
+		{
+#if defined(_MSC_VER)
+			int registers[4];
+			__cpuid(registers, 1);
+			auto const isXSaveEnabled = (registers[2] & (1 << 27)) != 0;
+			if (!isXSaveEnabled || (_xgetbv(0) & 0x6) != 0x6)
+			{
+				return false;
+			}
+			__cpuidex(registers, 7, 0);
+			return (registers[1] & (1 << 5)) != 0;
+#else
+			return __builtin_cpu_supports("avx2");
+#endif
+		}
+#endif
+
+		/// @brief Picks the widest block classifier the running CPU supports, once.
+		inline json_classify_function get_json_classify_function()
+		{
+#ifdef VOB_MISTD_JSON_X64
+			static auto const s_classify = is_avx2_supported()
+				? &classify_json_block_avx2 : &classify_json_block_sse2;
+			return s_classify;
+#else
+			return &classify_json_block_scalar;
+#endif
+		}
+
+		/// @brief Mask of the bytes whose prefix has an odd number of set bits, which for quotes are the bytes inside
+		/// strings (opening quote included, closing quote excluded).
+		inline std::uint64_t prefix_xor(std::uint64_t a_bits)
+		{
+			a_bits ^= a_bits << 1;
+			a_bits ^= a_bits << 2;
+			a_bits ^= a_bits << 4;
+			a_bits ^= a_bits << 8;
+			a_bits ^= a_bits << 16;
+			a_bits ^= a_bits << 32;
+			return a_bits;
+		}
+
+		/// @brief Finds the characters escaped by a backslash: those after an odd-length sequence of backslashes.
+		/// a_isEscaped carries whether the first character of the next block is escaped.
+		inline std::uint64_t find_json_escaped(std::uint64_t a_backslashes, std::uint64_t& a_isEscaped)
+		{
+			constexpr std::uint64_t evenBits = 0x5555'5555'5555'5555;
+			a_backslashes &= ~a_isEscaped;
+			auto const followsEscape = (a_backslashes << 1) | a_isEscaped;
+			auto const oddSequenceStarts = a_backslashes & ~evenBits & ~followsEscape;
+			auto const sequencesStartingOnEvenBits = oddSequenceStarts + a_backslashes;
+			a_isEscaped = sequencesStartingOnEvenBits < oddSequenceStarts ? 1 : 0;
+			auto const invertMask = sequencesStartingOnEvenBits << 1;
+			return (evenBits ^ invertMask) & followsEscape;
+		}
+	}
+
+	/// @brief First stage of a two-stage JSON parse: the positions of the structural characters of a document, found
+	/// 64 bytes at a time with SSE2 or AVX2 when available.
+	/// Structural characters are the operators outside of strings, both quotes of every string, and the first
+	/// character of every number or literal. The second stage walks these positions instead of every byte.
+	template <typename TAllocator = std::allocator<std::uint32_t>>
+	class basic_json_structural_index
+	{
+	public:
+#pragma region CREATORS
+		/// @brief Creates an empty index.
+		explicit basic_json_structural_index(TAllocator const& a_allocator = {})
+			: m_positions{ a_allocator }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief Provides the positions of the structural characters, relative to the start of the document.
+		[[nodiscard]] std::span<std::uint32_t const> get_positions() const
+		{
+			return m_positions;
+		}
+
+		/// @brief Provides the position of the first unescaped control character inside a string, or the document
+		/// size if there is none.
+		[[nodiscard]] std::size_t get_first_control_position() const
+		{
+			return m_firstControlPosition;
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Indexes [first, last), replacing the previous positions. Documents must be smaller than 4 GB.
+		void build(char const* const a_first, char const* const a_last)
+		{
+			auto const size = static_cast<std::size_t>(a_last - a_first);
+			assert(size < std::numeric_limits<std::uint32_t>::max());
+			m_positions.clear();
+			m_firstControlPosition = size;
+
+			// Most documents have no more structural characters than a quarter of their bytes
+			m_positions.reserve(size / 4 + 64);
+
+			auto const classify = detail::get_json_classify_function();
+			block_state state;
+			std::size_t offset = 0;
+			for (; offset + 64 <= size; offset += 64)
+			{
+				index_block(classify(a_first + offset), offset, state);
+			}
+			if (offset < size)
+			{
+				// The tail is padded with whitespaces, which are never structural
+				char block[64];
+				std::memset(block, ' ', sizeof(block));
+				std::memcpy(block, a_first + offset, size - offset);
+				index_block(classify(block), offset, state);
+			}
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_TYPES
+		/// @brief What a block needs to know about the end of the previous one.
+		struct block_state
+		{
+			std::uint64_t m_isEscaped = 0;
+			std::uint64_t m_isInString = 0;
+			std::uint64_t m_isScalar = 0;
+		};
+#pragma endregion
+
+#pragma region PRIVATE_DATA
+		std::vector<std::uint32_t, TAllocator> m_positions;
+		std::size_t m_firstControlPosition = 0;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		void index_block(detail::json_block_masks const& a_masks, std::size_t const a_offset, block_state& a_state)
+		{
+			auto const escaped = detail::find_json_escaped(a_masks.backslashes, a_state.m_isEscaped);
+			auto const quotes = a_masks.quotes & ~escaped;
+			auto const isInString = detail::prefix_xor(quotes) ^ a_state.m_isInString;
+			a_state.m_isInString = static_cast<std::uint64_t>(static_cast<std::int64_t>(isInString) >> 63);
+
+			// A scalar starts on any character that is neither an operator nor a whitespace, and does not follow
+			// another such character
+			auto const scalars = ~(a_masks.operators | a_masks.whitespaces);
+			auto const nonQuoteScalars = scalars & ~quotes;
+			auto const followsScalar = (nonQuoteScalars << 1) | a_state.m_isScalar;
+			a_state.m_isScalar = nonQuoteScalars >> 63;
+			auto const scalarStarts = scalars & ~followsScalar;
+
+			auto const controls = a_masks.controls & isInString & ~quotes;
+			if (controls != 0)
+			{
+				m_firstControlPosition = std::min(
+					m_firstControlPosition, a_offset + static_cast<std::size_t>(std::countr_zero(controls)));
+			}
+
+			auto structurals = ((a_masks.operators | scalarStarts) & ~isInString) | quotes;
+			auto const size = m_positions.size();
+			m_positions.resize(size + std::popcount(structurals));
+			for (auto position = m_positions.data() + size; structurals != 0; structurals &= structurals - 1)
+			{
+				*position++ = static_cast<std::uint32_t>(a_offset + std::countr_zero(structurals));
+			}
+		}
+#pragma endregion
+	};
+
+	using json_structural_index = basic_json_structural_index<>;
+
+	namespace pmr
+	{
+		using json_structural_index = basic_json_structural_index<std::pmr::polymorphic_allocator<std::uint32_t>>;
+	}
+}
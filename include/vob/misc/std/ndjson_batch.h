@@ -0,0 +1,213 @@
+#pragma once
+
+#include "json_lazy_value.h"
+#include "json_parser.h"
+
+#include "../multithread/parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+
+namespace vob::mistd
+{
+	/// @brief Records of a newline-delimited JSON text (one value per line, blank lines ignored), parsed in parallel
+	/// into one pmr::json_value per record, in the order of the text.
+	/// Records are split in chunks, each parsed by one thread at a time into its own monotonic arena, so parsing
+	/// allocates without synchronization and a whole batch is released at once.
+	class ndjson_batch
+	{
+	public:
+#pragma region TYPES
+		using value_type = pmr::json_value;
+#pragma endregion
+
+#pragma region CREATORS
+		/// @brief Creates an empty batch, whose arenas get their memory from a_upstream. The upstream resource must
+		/// be thread-safe, as arenas grow from all threads.
+		explicit ndjson_batch(std::pmr::memory_resource* const a_upstream = std::pmr::get_default_resource())
+			: m_upstream{ a_upstream }
+			, m_texts{ a_upstream }
+			, m_records{ a_upstream }
+			, m_isValid{ a_upstream }
+		{}
+
+		ndjson_batch(ndjson_batch const&) = delete;
+		ndjson_batch(ndjson_batch&&) = delete;
+#pragma endregion
+
+#pragma region ACCESSORS
+		[[nodiscard]] std::size_t size() const
+		{
+			return m_records.size();
+		}
+
+		[[nodiscard]] bool empty() const
+		{
+			return m_records.empty();
+		}
+
+		/// @brief Provides the value of a record, which is null if the record is not valid JSON.
+		[[nodiscard]] value_type const& operator[](std::size_t const a_index) const
+		{
+			return m_records[a_index];
+		}
+
+		[[nodiscard]] auto begin() const
+		{
+			return m_records.begin();
+		}
+
+		[[nodiscard]] auto end() const
+		{
+			return m_records.end();
+		}
+
+		/// @brief Whether a record is a valid JSON value.
+		[[nodiscard]] bool is_valid(std::size_t const a_index) const
+		{
+			return m_isValid[a_index] != 0;
+		}
+
+		/// @brief Provides the number of records that are not valid JSON.
+		[[nodiscard]] std::size_t get_invalid_count() const
+		{
+			return static_cast<std::size_t>(std::count(m_isValid.begin(), m_isValid.end(), std::uint8_t{ 0 }));
+		}
+
+		/// @brief Provides the text of a record, valid as long as the parsed text is.
+		[[nodiscard]] std::string_view get_text(std::size_t const a_index) const
+		{
+			return m_texts[a_index];
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		ndjson_batch& operator=(ndjson_batch const&) = delete;
+		ndjson_batch& operator=(ndjson_batch&&) = delete;
+
+		/// @brief Replaces the records of this batch by those of a text, parsed on all threads of a worker.
+		/// Records are parsed in chunks of a_chunkSize records, 0 picking one that gives each thread several chunks.
+		/// Returns whether all records are valid JSON. Must not be called during an execution of the worker.
+		template <typename TWorker>
+		bool parse(TWorker& a_worker, std::string_view const a_text, std::size_t a_chunkSize = 0)
+		{
+			// Chunks per thread, so faster threads can take over the records of slower ones
+			constexpr std::size_t chunksPerThread = 8;
+
+			clear();
+			split_records(a_text);
+			if (m_texts.empty())
+			{
+				return true;
+			}
+
+			auto const recordCount = m_texts.size();
+			if (a_chunkSize == 0)
+			{
+				a_chunkSize = std::max<std::size_t>(1, recordCount / (a_worker.get_thread_count() * chunksPerThread));
+			}
+			auto const chunkCount = (recordCount + a_chunkSize - 1) / a_chunkSize;
+
+			// Each record allocates from the arena of its chunk, sized after the text of the chunk
+			m_arenas.reserve(chunkCount);
+			m_records.reserve(recordCount);
+			for (std::size_t chunk = 0; chunk < chunkCount; ++chunk)
+			{
+				auto const first = chunk * a_chunkSize;
+				auto const last = std::min(first + a_chunkSize, recordCount);
+				auto const textSize = static_cast<std::size_t>(
+					m_texts[last - 1].data() + m_texts[last - 1].size() - m_texts[first].data());
+				m_arenas.emplace_back(std::make_unique<std::pmr::monotonic_buffer_resource>(
+					s_arenaSizeFactor * textSize, m_upstream));
+				for (auto record = first; record < last; ++record)
+				{
+					m_records.emplace_back(std::pmr::polymorphic_allocator<char>{ m_arenas.back().get() });
+				}
+			}
+			m_isValid.assign(recordCount, 0);
+
+			mismt::parallel_for(
+				a_worker,
+				0,
+				chunkCount,
+				[this, a_chunkSize, recordCount](std::size_t const a_chunk)
+				{
+					auto const last = std::min((a_chunk + 1) * a_chunkSize, recordCount);
+					for (auto record = a_chunk * a_chunkSize; record < last; ++record)
+					{
+						parse_record(record);
+					}
+				},
+				1);
+			return get_invalid_count() == 0;
+		}
+
+		/// @brief Removes all records and releases their memory.
+		void clear()
+		{
+			m_isValid.clear();
+			m_records.clear();
+			m_texts.clear();
+			m_arenas.clear();
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		/// @brief Arena bytes reserved per byte of text, as values take more room than their text.
+		constexpr static std::size_t s_arenaSizeFactor = 4;
+
+		std::pmr::memory_resource* m_upstream;
+		/// @brief Declared before the records, which must be destroyed first.
+		std::vector<std::unique_ptr<std::pmr::monotonic_buffer_resource>> m_arenas;
+		std::pmr::vector<std::string_view> m_texts;
+		std::pmr::vector<value_type> m_records;
+		/// @brief Bytes rather than bits, as records of different threads may be next to each other.
+		std::pmr::vector<std::uint8_t> m_isValid;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		/// @brief Finds the records of a text, lines with only whitespaces excluded.
+		void split_records(std::string_view const a_text)
+		{
+			auto current = a_text.data();
+			auto const last = a_text.data() + a_text.size();
+			while (current != last)
+			{
+				auto const newline = static_cast<char const*>(
+					std::memchr(current, '\n', static_cast<std::size_t>(last - current)));
+				auto const lineLast = newline != nullptr ? newline : last;
+				auto const first = detail::skip_json_whitespaces(current, lineLast);
+				if (first != lineLast)
+				{
+					m_texts.emplace_back(first, static_cast<std::size_t>(lineLast - first));
+				}
+				current = newline != nullptr ? newline + 1 : last;
+			}
+		}
+
+		void parse_record(std::size_t const a_index)
+		{
+			auto const text = m_texts[a_index];
+			auto& record = m_records[a_index];
+			auto const result = parse_json(text, record);
+			auto const last = text.data() + text.size();
+			if (result.ec == std::errc{} && detail::skip_json_whitespaces(result.ptr, last) == last)
+			{
+				m_isValid[a_index] = 1;
+			}
+			else
+			{
+				record.set<pmr::json_null>();
+			}
+		}
+#pragma endregion
+	};
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "indexed_vector_map.h"
+#include "string_map_key.h"
+
+#include <string>
+#include <string_view>
+
+
+namespace vob::mistd
+{
+	/// @brief An indexed_vector_map of strings, whose lookups take string views without allocating.
+	template <
+		typename TValue,
+		typename TString = std::string,
+		typename TStringView = std::string_view,
+		typename THash = basic_string_map_key_hash<TString, TStringView>,
+		typename TEqualTo = std::equal_to<>,
+		typename TAllocator = std::allocator<std::pair<basic_string_map_key<TString, TStringView> const, TValue>>>
+	using string_indexed_vector_map = indexed_vector_map<
+		basic_string_map_key<TString, TStringView>, TValue, THash, TEqualTo, TAllocator>;
+
+	namespace pmr
+	{
+		template <typename TValue>
+		using string_indexed_vector_map = mistd::string_indexed_vector_map<
+			TValue,
+			std::pmr::string,
+			std::string_view,
+			string_map_key_hash,
+			std::equal_to<>,
+			std::pmr::polymorphic_allocator<std::pair<pmr::string_map_key const, TValue>>>;
+	}
+}
@@ -74,12 +74,14 @@ namespace vob::mistd
 			m_string = a_other.m_string.data() == a_other.m_stringView.data()
 				? std::move(a_other.m_string) : TString{ a_other.m_stringView };
 			m_stringView = m_string;
+			return *this;
 		}
 
 		auto& operator=(basic_string_map_key const& a_other)
 		{
 			m_string = TString{ a_other.m_stringView };
 			m_stringView = m_string;
+			return *this;
 		}
 #pragma endregion
 
@@ -95,6 +95,12 @@ namespace vob::mistd
 			return emplace(std::make_pair(std::move(a_key), std::move(a_value)));
 		}
 
+		/// @brief TODO
+		void clear()
+		{
+			m_data.clear();
+		}
+
 		/// @brief TODO
 		void reserve(std::size_t const a_capacity)
 		{
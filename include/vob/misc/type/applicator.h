@@ -1,69 +1,23 @@
 #pragma once
 
 #include "../std/conditional_const.h"
+#include "../std/indexed_vector_map.h"
 
 #include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <type_traits>
 #include <typeindex>
-#include <unordered_map>
+#include <typeinfo>
+#include <vector>
 
 namespace vob::misty
 {
-	namespace detail
-	{
-		/// @brief TODO
-		template <bool t_const, typename... TArgs>
-		class type_applicator_base
-		{
-		public:
-#pragma region CREATORS
-			virtual ~type_applicator_base() = default;
-#pragma endregion
-
-#pragma region ACCESSORS
-			/// @brief Applies inner logic to provided object and arguments.
-			virtual void apply(mistd::conditional_const_t<t_const, void>* a_object, TArgs&&... a_args) const = 0;
-#pragma endregion
-		};
-
-		/// @brief An applicator of TFunc to TValue and TArgs
-		template <
-			typename TValue,
-			template <typename> typename TFunc,
-			bool t_const,
-			typename... TArgs
-		>
-		class basic_type_applicator final
-			: public type_applicator_base<t_const, TArgs...>
-		{
-		public:
-#pragma region CREATORS
-			/// @brief Constructs a basic_type_applicator from the functor that should be applied to provided objects.
-			explicit basic_type_applicator(TFunc<TValue> a_functor)
-				: m_functor{ std::move(a_functor) }
-			{}
-#pragma endregion
-
-#pragma region ACCESSORS
-			/// @brief Applies inner logic to provided object and arguments.
-			/// Caller must guarantee that provided object is a TValue pointer.
-			void apply(mistd::conditional_const_t<t_const, void>* a_object, TArgs&&... a_args) const override
-			{
-				using Type = mistd::conditional_const_t<t_const, TValue>;
-				auto& t_object = *reinterpret_cast<Type*>(a_object);
-				m_functor(t_object, std::forward<TArgs>(a_args)...);
-			}
-#pragma endregion
-
-		private:
-#pragma region PRIVATE_DATA
-			TFunc<TValue> m_functor;
-#pragma endregion
-		};
-	}
-
 	/// @brief A templated class to apply some logic to a type unknown at compile time.
+	/// Registered types get consecutive ids, which index a contiguous table of function pointers. The id of an
+	/// object's type is found in a hash table keyed by the address of its std::type_info, so a dispatch costs a
+	/// pointer hash, a probe and an indirect call.
 	template <
 		template <typename> typename TFunc,
 		typename TAllocator,
@@ -72,17 +26,25 @@ namespace vob::misty
 	class basic_applicator
 	{
 #pragma region PRIVATE_TYPES
-		using type_applicator_base = detail::type_applicator_base<t_const, TArgs...>;
+		using object_pointer = mistd::conditional_const_t<t_const, void>*;
+		using apply_function = void (*)(object_pointer, void const*, TArgs&&...);
 
-		template <typename TValue>
-		using basic_type_applicator = detail::basic_type_applicator<TValue, TFunc, t_const, TArgs...>;
+		/// @brief A registered type: its std::type_info, the functor applied to it, and the function applying it.
+		struct type_entry
+		{
+			std::type_info const* type;
+			void const* functor;
+			apply_function apply;
+		};
 #pragma endregion
 
 	public:
 #pragma region CREATORS
 		/// @brief Constructs a basic_applicator from the allocator used to allocate the typed applicators.
 		explicit basic_applicator(TAllocator const& a_allocator = {})
-			: m_typeApplicators{ allocator{ a_allocator } }
+			: m_functors{ functor_allocator{ a_allocator } }
+			, m_entries{ entry_allocator{ a_allocator } }
+			, m_index{ index_allocator{ a_allocator } }
 		{}
 #pragma endregion
 
@@ -90,16 +52,21 @@ namespace vob::misty
 		/// @brief Returns whether or not a type has been registered to be handled by this applicator.
 		bool is_registered(std::type_index const a_typeIndex) const
 		{
-			auto it = m_typeApplicators.find(a_typeIndex);
-			auto e = m_typeApplicators.end();
-			return it != e;
+			for (auto const& entry : m_entries)
+			{
+				if (std::type_index{ *entry.type } == a_typeIndex)
+				{
+					return true;
+				}
+			}
+			return false;
 		}
 
 		/// @brief Returns whether or not a type has been registered to be handled by this applicator.
 		template <typename TValue>
 		bool is_registered() const
 		{
-			return is_registered(typeid(TValue));
+			return find_type_id(typeid(TValue)) != m_entries.size();
 		}
 
 		/// @brief Applies this applicator to the exact type of passed object.
@@ -107,14 +74,15 @@ namespace vob::misty
 		template <typename TValue>
 		bool apply(TValue& a_object, TArgs&&... a_args) const
 		{
-			assert(is_registered(typeid(a_object)));
-			auto const t_it = m_typeApplicators.find(typeid(a_object));
-			if (t_it == m_typeApplicators.end())
+			auto const typeId = find_type_id(typeid(a_object));
+			assert(typeId != m_entries.size());
+			if (typeId == m_entries.size())
 			{
 				return false;
 			}
 
-			t_it->second->apply(&a_object, std::forward<TArgs>(a_args)...);
+			auto const& entry = m_entries[typeId];
+			entry.apply(&a_object, entry.functor, std::forward<TArgs>(a_args)...);
 			return true;
 		}
 #pragma endregion
@@ -125,29 +93,97 @@ namespace vob::misty
 		void register_type(TFunc<TValue> a_functor = {})
 		{
 			assert(!is_registered<TValue>());
-			auto allocator = m_typeApplicators.get_allocator();
-			m_typeApplicators.emplace(
-				typeid(TValue)
-				, std::allocate_shared<basic_type_applicator<TValue>>(allocator, a_functor)
-			);
+			auto const& functor = m_functors.emplace_back(std::allocate_shared<TFunc<TValue> const>(
+				m_functors.get_allocator(), std::move(a_functor)));
+			m_entries.push_back({ &typeid(TValue), functor.get(), &apply_typed<TValue> });
+
+			auto const typeId = m_entries.size() - 1;
+			if (index_table::get_capacity(m_entries.size()) != m_index.size())
+			{
+				rebuild_index();
+			}
+			else
+			{
+				index_table::insert(m_index, hash_type(typeid(TValue)), typeId);
+			}
 		}
 #pragma endregion
 
 	private:
 #pragma region PRIVATE_TYPES
-		using allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<
-			std::pair<std::type_index const, std::shared_ptr<type_applicator_base>>
-		>;
+		using index_table = mistd::detail::index_table;
+		using functor_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<
+			std::shared_ptr<void const>>;
+		using entry_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<type_entry>;
+		using index_allocator = typename std::allocator_traits<TAllocator>::template rebind_alloc<std::uint32_t>;
 #pragma endregion
 
 #pragma region PRIVATE_DATA
-		std::unordered_map<
-			std::type_index
-			, std::shared_ptr<type_applicator_base>
-			, std::hash<std::type_index>
-			, std::equal_to<>
-			, allocator
-		> m_typeApplicators;
+		/// @brief Owns the functors of the entries, shared by copies of this applicator.
+		std::vector<std::shared_ptr<void const>, functor_allocator> m_functors;
+		/// @brief Registered types, indexed by their id.
+		std::vector<type_entry, entry_allocator> m_entries;
+		/// @brief Hash table of the ids of registered types, keyed by the address of their std::type_info.
+		std::vector<std::uint32_t, index_allocator> m_index;
+#pragma endregion
+
+#pragma region PRIVATE_CLASS_METHODS
+		template <typename TValue>
+		static void apply_typed(object_pointer const a_object, void const* const a_functor, TArgs&&... a_args)
+		{
+			using Type = mistd::conditional_const_t<t_const, TValue>;
+			auto const& functor = *static_cast<TFunc<TValue> const*>(a_functor);
+			functor(*static_cast<Type*>(a_object), std::forward<TArgs>(a_args)...);
+		}
+
+		/// @brief Hashes the address of a std::type_info, whose low bits are the same for all of them.
+		static std::size_t hash_type(std::type_info const& a_type)
+		{
+			auto const address = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(&a_type));
+			return static_cast<std::size_t>((address * 0x9E3779B97F4A7C15) >> 32);
+		}
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+		/// @brief Provides the id of a type, or the number of registered types if it is not registered.
+		std::size_t find_type_id(std::type_info const& a_type) const
+		{
+			if (m_entries.empty())
+			{
+				return 0;
+			}
+
+			auto const typeId = index_table::find(
+				m_index,
+				hash_type(a_type),
+				m_entries.size(),
+				[this, &a_type](std::size_t const a_typeId) { return m_entries[a_typeId].type == &a_type; });
+			if (typeId != m_entries.size())
+			{
+				return typeId;
+			}
+
+			// A type can have several std::type_info objects, for instance across shared libraries
+			for (auto otherTypeId = std::size_t{ 0 }; otherTypeId < m_entries.size(); ++otherTypeId)
+			{
+				if (*m_entries[otherTypeId].type == a_type)
+				{
+					return otherTypeId;
+				}
+			}
+			return m_entries.size();
+		}
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		void rebuild_index()
+		{
+			m_index.assign(index_table::get_capacity(m_entries.size()), 0);
+			for (auto typeId = std::size_t{ 0 }; typeId < m_entries.size(); ++typeId)
+			{
+				index_table::insert(m_index, hash_type(*m_entries[typeId].type), typeId);
+			}
+		}
 #pragma endregion
 	};
 
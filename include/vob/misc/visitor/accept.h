@@ -129,8 +129,12 @@ namespace vob::misvi
 	bool accept(TVisitor& a_visitor, mistd::vector_map<TKey, TValue, TKeyEqual, TAllocator> const& a_map)
 	{
 		size_tag sizeTag{ a_map.size() };
+		if (!a_visitor.visit(sizeTag))
+		{
+			return false;
+		}
 		auto index = 0u;
-		for (auto pair : a_map)
+		for (auto const& pair : a_map)
 		{
 			a_visitor.visit(ivp(index++, pair));
 		}
@@ -249,7 +253,7 @@ namespace vob::misvi
 		}
 
 		a_variant = a_factory(index);
-		return std::visit([a_visitor](auto&& a_value)
+		return std::visit([&a_visitor](auto&& a_value)
 		{
 			return a_visitor.visit(nvp("data", a_value));
 		}, a_variant);
@@ -270,7 +274,7 @@ namespace vob::misvi
 		std::visit([&a_visitor](auto&& a_value)
 		{
 			a_visitor.visit(nvp("data", a_value));
-		});
+		}, a_variant);
 		return true;
 	}
 #pragma endregion
@@ -472,8 +476,9 @@ namespace vob::misvi
 	template <typename TVisitor, typename TValue>
 	bool accept(TVisitor& a_visitor, std::optional<TValue> const& a_optional)
 	{
-		a_visitor.visit(nvp("has_value", a_optional.has_value()));
-		if (a_visitor.has_value())
+		bool const hasValue = a_optional.has_value();
+		a_visitor.visit(nvp("has_value", hasValue));
+		if (hasValue)
 		{
 			a_visitor.visit(nvp("value", a_optional.value()));
 		}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+
+namespace vob::misvi
+{
+	namespace detail
+	{
+		/// @brief Type in which binary_writer and binary_reader store sizes, whatever the size of std::size_t.
+		using binary_size_type = std::uint64_t;
+
+		/// @brief Whether values of a type are stored as their bytes, so contiguous ranges of them are copied at once.
+		/// Booleans are excluded, as not all their bytes are valid.
+		template <typename TValue>
+		constexpr bool is_binary_trivial_v = std::is_arithmetic_v<TValue> && !std::is_same_v<TValue, bool>;
+
+		/// @brief Copies a_count values of a_elementSize bytes between native and little-endian orders, which is
+		/// the same operation both ways.
+		inline void copy_binary_little_endian(
+			std::byte* const a_destination,
+			std::byte const* const a_source,
+			std::size_t const a_count,
+			std::size_t const a_elementSize)
+		{
+			if (a_count == 0)
+			{
+				return;
+			}
+			if constexpr (std::endian::native == std::endian::little)
+			{
+				std::memcpy(a_destination, a_source, a_count * a_elementSize);
+			}
+			else
+			{
+				for (auto i = std::size_t{ 0 }; i < a_count; ++i)
+				{
+					auto const offset = i * a_elementSize;
+					std::reverse_copy(
+						a_source + offset, a_source + offset + a_elementSize, a_destination + offset);
+				}
+			}
+		}
+	}
+}
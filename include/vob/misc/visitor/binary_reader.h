@@ -0,0 +1,259 @@
+#pragma once
+
+#include "applicator.h"
+#include "binary_format.h"
+#include "container.h"
+#include "index_value_pair.h"
+#include "is_visitable.h"
+#include "name_value_pair.h"
+#include "size_tag.h"
+
+#include "../hash/string_id.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+
+namespace vob::misvi
+{
+	/// @brief Reads values written by a binary_writer, visited the same way they were when written.
+	/// Reads past the end of the data, or of std::array values of another size, fail without reading anything, as
+	/// do all reads after them. As every element of an array takes at least a byte, arrays larger than the rest of
+	/// the data are also rejected before their elements are allocated.
+	template <typename TContext, typename TApplicatorAllocator = std::allocator<char>>
+	class binary_reader
+	{
+#pragma region PRIVATE_TYPES
+		using self = binary_reader<TContext, TApplicatorAllocator>;
+#pragma endregion
+	public:
+#pragma region CREATORS
+		/// @brief TODO
+		binary_reader(applicator<false, self, TApplicatorAllocator> const& a_applicator, TContext a_context)
+			: m_applicator{ a_applicator }
+			, m_context{ std::forward<TContext>(a_context) }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief TODO
+		[[nodiscard]] auto const& get_applicator() const
+		{
+			return m_applicator;
+		}
+
+		/// @brief TODO
+		[[nodiscard]] auto const& get_context() const
+		{
+			return m_context;
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Reads a value from the start of some data, and provides how many bytes it took, or nothing if
+		/// the data ends before the value does.
+		template <typename TValue>
+		std::optional<std::size_t> read(std::span<std::byte const> const a_data, TValue& a_value)
+		{
+			assert(m_current == nullptr);
+			m_first = a_data.data();
+			m_current = m_first;
+			m_last = a_data.data() + a_data.size();
+			m_hasFailed = false;
+			visit(a_value);
+			auto const size = static_cast<std::size_t>(m_current - m_first);
+			m_first = m_current = m_last = nullptr;
+			if (m_hasFailed)
+			{
+				return std::nullopt;
+			}
+			return size;
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_free<self, TValue> && (!std::is_arithmetic_v<TValue>)
+		bool visit(TValue& a_value)
+		{
+			return accept(*this, a_value);
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_member<self, TValue>
+		bool visit(TValue& a_value)
+		{
+			return a_value.accept(*this);
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_static<self, TValue>
+		bool visit(TValue& a_value)
+		{
+			return TValue::accept(*this, a_value);
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires detail::is_binary_trivial_v<TValue>
+		bool visit(TValue& a_number)
+		{
+			return read_trivial(&a_number, 1);
+		}
+
+		/// @brief TODO
+		bool visit(bool& a_boolean)
+		{
+			std::uint8_t byte = 0;
+			if (!read_trivial(&byte, 1))
+			{
+				return false;
+			}
+			a_boolean = byte != 0;
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TChar, typename TCharTraits, typename TAllocator>
+		bool visit(std::basic_string<TChar, TCharTraits, TAllocator>& a_string)
+		{
+			std::size_t size = 0;
+			if (!read_size(size, sizeof(TChar)))
+			{
+				return false;
+			}
+			a_string.resize(size);
+			return read_trivial(a_string.data(), size);
+		}
+
+		/// @brief TODO
+		template <typename TChar, typename TCharTraits>
+		bool visit(mishs::basic_string_id<TChar, TCharTraits>& a_id)
+		{
+			std::uint64_t id = 0;
+			if (!visit(id))
+			{
+				return false;
+			}
+			a_id.assign(id);
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TValue, typename TAllocator>
+		requires detail::is_binary_trivial_v<TValue>
+		bool visit(std::vector<TValue, TAllocator>& a_vector)
+		{
+			std::size_t size = 0;
+			if (!read_size(size, sizeof(TValue)))
+			{
+				return false;
+			}
+			a_vector.resize(size);
+			return read_trivial(a_vector.data(), size);
+		}
+
+		/// @brief TODO
+		template <typename TValue, std::size_t t_size>
+		requires detail::is_binary_trivial_v<TValue>
+		bool visit(std::array<TValue, t_size>& a_array)
+		{
+			std::size_t size = 0;
+			if (!read_size(size, sizeof(TValue)))
+			{
+				return false;
+			}
+			if (size != t_size)
+			{
+				m_hasFailed = true;
+				return false;
+			}
+			return read_trivial(a_array.data(), t_size);
+		}
+
+		/// @brief TODO
+		bool visit(size_tag& a_sizeTag)
+		{
+			return read_size(a_sizeTag.size, 1);
+		}
+
+		/// @brief Reads the element, which must be the next one of the array being read.
+		template <typename TValue>
+		bool visit(index_value_pair<TValue> a_indexValuePair)
+		{
+			return visit(a_indexValuePair.value);
+		}
+
+		/// @brief Reads the member value, which must be the next one of the object being read.
+		template <typename TValue>
+		bool visit(name_value_pair<TValue> a_nameValuePair)
+		{
+			return visit(a_nameValuePair.value);
+		}
+
+		/// @brief TODO
+		template <typename TContainer, typename TFactory>
+		bool visit(container<TContainer, TFactory> const& a_container)
+		{
+			return accept(*this, a_container);
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		applicator<false, self, TApplicatorAllocator> const& m_applicator;
+		TContext m_context;
+		std::byte const* m_first = nullptr;
+		std::byte const* m_current = nullptr;
+		std::byte const* m_last = nullptr;
+		bool m_hasFailed = false;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		/// @brief Reads a size, which must leave room for that many elements of a_elementSize bytes.
+		bool read_size(std::size_t& a_size, std::size_t const a_elementSize)
+		{
+			detail::binary_size_type size = 0;
+			if (!read_trivial(&size, 1))
+			{
+				return false;
+			}
+			if (size > static_cast<std::size_t>(m_last - m_current) / a_elementSize)
+			{
+				m_hasFailed = true;
+				return false;
+			}
+			a_size = static_cast<std::size_t>(size);
+			return true;
+		}
+
+		template <typename TValue>
+		bool read_trivial(TValue* const a_values, std::size_t const a_count)
+		{
+			if (m_hasFailed || a_count > static_cast<std::size_t>(m_last - m_current) / sizeof(TValue))
+			{
+				m_hasFailed = true;
+				return false;
+			}
+			detail::copy_binary_little_endian(
+				reinterpret_cast<std::byte*>(a_values), m_current, a_count, sizeof(TValue));
+			m_current += a_count * sizeof(TValue);
+			return true;
+		}
+#pragma endregion
+	};
+
+	namespace pmr
+	{
+		/// @brief TODO
+		template <typename TContext, typename TApplicatorAllocator = std::pmr::polymorphic_allocator<char>>
+		using binary_reader = binary_reader<TContext, TApplicatorAllocator>;
+	}
+}
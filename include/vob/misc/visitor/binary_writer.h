@@ -0,0 +1,225 @@
+#pragma once
+
+#include "applicator.h"
+#include "binary_format.h"
+#include "container.h"
+#include "index_value_pair.h"
+#include "is_visitable.h"
+#include "name_value_pair.h"
+#include "size_tag.h"
+
+#include "../hash/string_id.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace vob::misvi
+{
+	/// @brief Writes values in a compact binary format, read back by binary_reader:
+	/// - arithmetic values are stored as their little-endian bytes, booleans as a single byte,
+	/// - sizes of arrays and strings are stored as 64 bits unsigned integers before their content,
+	/// - members are stored in the order they are visited, without their name.
+	/// Vectors, arrays and strings of arithmetic values are copied at once rather than element by element.
+	template <
+		typename TContext,
+		typename TBuffer = std::vector<std::byte>,
+		typename TApplicatorAllocator = std::allocator<char>>
+	class binary_writer
+	{
+#pragma region PRIVATE_TYPES
+		using self = binary_writer<TContext, TBuffer, TApplicatorAllocator>;
+
+		static_assert(sizeof(typename TBuffer::value_type) == 1, "buffer elements must be bytes");
+#pragma endregion
+	public:
+#pragma region CREATORS
+		/// @brief TODO
+		binary_writer(applicator<true, self, TApplicatorAllocator> const& a_applicator, TContext a_context)
+			: m_applicator{ a_applicator }
+			, m_context{ std::forward<TContext>(a_context) }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief TODO
+		[[nodiscard]] auto const& get_applicator() const
+		{
+			return m_applicator;
+		}
+
+		/// @brief TODO
+		[[nodiscard]] auto const& get_context() const
+		{
+			return m_context;
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Appends a value to a buffer of bytes, such as a std::vector<std::byte> or std::string.
+		template <typename TValue>
+		void write(TBuffer& a_buffer, TValue const& a_value)
+		{
+			assert(m_buffer == nullptr);
+			m_buffer = &a_buffer;
+			visit(a_value);
+			m_buffer = nullptr;
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_free<self, TValue const> && (!std::is_arithmetic_v<TValue>)
+		bool visit(TValue const& a_value)
+		{
+			return accept(*this, a_value);
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_member<self, TValue const>
+		bool visit(TValue const& a_value)
+		{
+			return a_value.accept(*this);
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_static<self, TValue const>
+		bool visit(TValue const& a_value)
+		{
+			return TValue::accept(*this, a_value);
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires detail::is_binary_trivial_v<TValue>
+		bool visit(TValue const& a_number)
+		{
+			write_trivial(&a_number, 1);
+			return true;
+		}
+
+		/// @brief TODO
+		bool visit(bool const a_boolean)
+		{
+			std::uint8_t const byte = a_boolean ? 1 : 0;
+			write_trivial(&byte, 1);
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TChar, typename TCharTraits>
+		bool visit(std::basic_string_view<TChar, TCharTraits> const a_string)
+		{
+			write_size(a_string.size());
+			write_trivial(a_string.data(), a_string.size());
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TChar, typename TCharTraits, typename TAllocator>
+		bool visit(std::basic_string<TChar, TCharTraits, TAllocator> const& a_string)
+		{
+			return visit(std::basic_string_view<TChar, TCharTraits>{ a_string });
+		}
+
+		/// @brief Writes the id of a string id, whatever it was constructed from.
+		template <typename TChar, typename TCharTraits>
+		bool visit(mishs::basic_string_id<TChar, TCharTraits> const& a_id)
+		{
+			return visit(a_id.get_id());
+		}
+
+		/// @brief TODO
+		template <typename TValue, typename TAllocator>
+		requires detail::is_binary_trivial_v<TValue>
+		bool visit(std::vector<TValue, TAllocator> const& a_vector)
+		{
+			write_size(a_vector.size());
+			write_trivial(a_vector.data(), a_vector.size());
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TValue, std::size_t t_size>
+		requires detail::is_binary_trivial_v<TValue>
+		bool visit(std::array<TValue, t_size> const& a_array)
+		{
+			write_size(t_size);
+			write_trivial(a_array.data(), t_size);
+			return true;
+		}
+
+		/// @brief TODO
+		bool visit(size_tag const& a_sizeTag)
+		{
+			write_size(a_sizeTag.size);
+			return true;
+		}
+
+		/// @brief Writes the element, which must be the next one of the array being written.
+		template <typename TValue>
+		bool visit(index_value_pair<TValue> a_indexValuePair)
+		{
+			return visit(std::as_const(a_indexValuePair.value));
+		}
+
+		/// @brief Writes the member value, without its name.
+		template <typename TValue>
+		bool visit(name_value_pair<TValue> a_nameValuePair)
+		{
+			return visit(std::as_const(a_nameValuePair.value));
+		}
+
+		/// @brief TODO
+		template <typename TContainer, typename TFactory>
+		bool visit(container<TContainer, TFactory> const& a_container)
+		{
+			return accept(*this, a_container);
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		applicator<true, self, TApplicatorAllocator> const& m_applicator;
+		TContext m_context;
+		TBuffer* m_buffer = nullptr;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		void write_size(std::size_t const a_size)
+		{
+			auto const size = static_cast<detail::binary_size_type>(a_size);
+			write_trivial(&size, 1);
+		}
+
+		template <typename TValue>
+		void write_trivial(TValue const* const a_values, std::size_t const a_count)
+		{
+			auto const offset = m_buffer->size();
+			m_buffer->resize(offset + a_count * sizeof(TValue));
+			detail::copy_binary_little_endian(
+				reinterpret_cast<std::byte*>(m_buffer->data() + offset),
+				reinterpret_cast<std::byte const*>(a_values),
+				a_count,
+				sizeof(TValue));
+		}
+#pragma endregion
+	};
+
+	namespace pmr
+	{
+		/// @brief TODO
+		template <
+			typename TContext,
+			typename TBuffer = std::pmr::vector<std::byte>,
+			typename TApplicatorAllocator = std::pmr::polymorphic_allocator<char>>
+		using binary_writer = binary_writer<TContext, TBuffer, TApplicatorAllocator>;
+	}
+}
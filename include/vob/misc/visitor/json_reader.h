@@ -27,6 +27,7 @@ namespace vob::misvi
 		using self = json_reader<
 			TContext, TJsonValue, TApplicatorAllocator, TStackAllocator>;
 		using json_value_ref = std::reference_wrapper<TJsonValue const>;
+		using stack_allocator = typename std::allocator_traits<TStackAllocator>::template rebind_alloc<json_value_ref>;
 #pragma endregion
 	public:
 #pragma region CREATORS
@@ -37,7 +38,7 @@ namespace vob::misvi
 			TStackAllocator a_allocator = {})
 			: m_applicator{ a_applicator }
 			, m_context{ std::forward<TContext>(a_context) }
-			, m_stack{ std::deque<json_value_ref, TStackAllocator>{ a_allocator } }
+			, m_stack{ std::deque<json_value_ref, stack_allocator>{ stack_allocator{ a_allocator } } }
 		{}
 #pragma endregion
 
@@ -96,7 +97,7 @@ namespace vob::misvi
 		bool visit(TValue& a_number)
 		{
 			auto const& currentValue = m_stack.top().get();
-			if (auto const number = currentValue.get<TJsonValue::number_type>())
+			if (auto const number = currentValue.template get<typename TJsonValue::number_type>())
 			{
 				std::visit([&a_number](auto const a_value){ a_number = static_cast<TValue>(a_value); }, number->value);
 				return true;
@@ -108,7 +109,7 @@ namespace vob::misvi
 		bool visit(bool& a_boolean)
 		{
 			auto const& currentValue = m_stack.top().get();
-			if (auto const boolean = currentValue.get<TJsonValue::boolean_type>())
+			if (auto const boolean = currentValue.template get<typename TJsonValue::boolean_type>())
 			{
 				a_boolean = boolean->value;
 				return true;
@@ -121,7 +122,7 @@ namespace vob::misvi
 		bool visit(std::basic_string<TChar, TCharTraits, TAllocator>& a_string)
 		{
 			auto const& currentValue = m_stack.top().get();
-			if (auto const string = currentValue.get<TJsonValue::string_type>())
+			if (auto const string = currentValue.template get<typename TJsonValue::string_type>())
 			{
 				a_string.assign(string->value);
 				return true;
@@ -133,7 +134,7 @@ namespace vob::misvi
 		bool visit(size_tag& a_sizeTag)
 		{
 			auto const& currentValue = m_stack.top().get();
-			if (auto const array = currentValue.get<TJsonValue::array_type>())
+			if (auto const array = currentValue.template get<typename TJsonValue::array_type>())
 			{
 				a_sizeTag.size = array->data.size();
 				return true;
@@ -147,8 +148,8 @@ namespace vob::misvi
 		{
 			// Current node is array
 			auto const& currentValue = m_stack.top().get();
-			auto const array = currentValue.get<TJsonValue::array_type>();
-			if (array == nullptr)
+			auto const array = currentValue.template get<typename TJsonValue::array_type>();
+			if (!array)
 			{
 				return false;
 			}
@@ -172,14 +173,14 @@ namespace vob::misvi
 		{
 			// Current node is object
 			auto const& currentValue = m_stack.top().get();
-			auto const object = currentValue.get<TJsonValue::object_type>();
-			if (object == nullptr)
+			auto const object = currentValue.template get<typename TJsonValue::object_type>();
+			if (!object)
 			{
 				return false;
 			}
 
-			// Key exists
-			auto const valueIt = object->data.find(a_nameValuePair.name);
+			// Key exists, its hash matching the compile-time one of the name
+			auto const valueIt = object->data.find(a_nameValuePair.name, a_nameValuePair.nameHash);
 			if (valueIt == object->data.end())
 			{
 				return false;
@@ -203,7 +204,7 @@ namespace vob::misvi
 #pragma region PRIVATE_DATA
 		applicator<false, self, TApplicatorAllocator> const& m_applicator;
 		TContext m_context;
-		std::stack<json_value_ref, std::deque<json_value_ref, TStackAllocator>> m_stack;
+		std::stack<json_value_ref, std::deque<json_value_ref, stack_allocator>> m_stack;
 #pragma endregion
 	};
 
@@ -0,0 +1,428 @@
+#pragma once
+
+#include "applicator.h"
+#include "container.h"
+#include "index_value_pair.h"
+#include "is_visitable.h"
+#include "name_value_pair.h"
+#include "size_tag.h"
+
+#include "../std/json_event_parser.h"
+
+#include <cassert>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace vob::misvi
+{
+	/// @brief Reads values straight from the events of a mistd::basic_json_event_parser, without building a
+	/// mistd::json_value tree first.
+	/// Array elements are visited by increasing index. Members can be visited in any order: members read past while
+	/// looking for another one are recorded as events, in a buffer shared by all objects being visited, and replayed
+	/// when visited. An object's recorded members are dropped once it is visited, so the buffer only holds members
+	/// of the objects being visited that were out of order.
+	template <
+		typename TContext,
+		typename TEventParser,
+		typename TApplicatorAllocator = std::allocator<char>,
+		typename TBufferAllocator = std::allocator<char>>
+	class json_stream_reader
+	{
+#pragma region PRIVATE_TYPES
+		using self = json_stream_reader<TContext, TEventParser, TApplicatorAllocator, TBufferAllocator>;
+		using json_event = mistd::json_event;
+		using number_value_type = typename TEventParser::number_value_type;
+
+		/// @brief An event of a recorded member, with what the parser provided along with it.
+		struct record
+		{
+			json_event event;
+			std::size_t depth;
+			/// @brief Range of the text of keys and strings in m_strings.
+			std::size_t stringFirst = 0;
+			std::size_t stringSize = 0;
+			number_value_type number{};
+			bool boolean = false;
+		};
+
+		using record_allocator = typename std::allocator_traits<TBufferAllocator>::template rebind_alloc<record>;
+		using string_allocator = typename std::allocator_traits<TBufferAllocator>::template rebind_alloc<char>;
+
+		/// @brief The value being visited: its first event, the depth once it is entered, where its first event is
+		/// if it is replayed, and the size of the buffers when it was entered.
+		struct frame
+		{
+			json_event event = json_event::none;
+			std::size_t depth = 0;
+			std::size_t replayFirst = 0;
+			std::size_t recordCount = 0;
+			std::size_t stringSize = 0;
+		};
+#pragma endregion
+	public:
+#pragma region CREATORS
+		/// @brief TODO
+		json_stream_reader(
+			applicator<false, self, TApplicatorAllocator> const& a_applicator,
+			TContext a_context,
+			TBufferAllocator const& a_allocator = {})
+			: m_applicator{ a_applicator }
+			, m_context{ std::forward<TContext>(a_context) }
+			, m_records{ record_allocator{ a_allocator } }
+			, m_strings{ string_allocator{ a_allocator } }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief TODO
+		[[nodiscard]] auto const& get_applicator() const
+		{
+			return m_applicator;
+		}
+
+		/// @brief TODO
+		[[nodiscard]] auto const& get_context() const
+		{
+			return m_context;
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Reads the next value of the parser. Syntax errors are reported by the parser's event.
+		template <typename TValue>
+		void read(TEventParser& a_parser, TValue& a_value)
+		{
+			assert(m_parser == nullptr);
+			m_parser = &a_parser;
+			m_parser->next();
+			visit(a_value);
+			m_parser = nullptr;
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_free<self, TValue> && (!std::is_arithmetic_v<TValue>)
+		bool visit(TValue& a_value)
+		{
+			return visit_composite([this, &a_value]() { return accept(*this, a_value); });
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_member<self, TValue>
+		bool visit(TValue& a_value)
+		{
+			return visit_composite([this, &a_value]() { return a_value.accept(*this); });
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_static<self, TValue>
+		bool visit(TValue& a_value)
+		{
+			return visit_composite([this, &a_value]() { return TValue::accept(*this, a_value); });
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires std::is_arithmetic_v<TValue>
+		bool visit(TValue& a_number)
+		{
+			if (get_event() != json_event::number)
+			{
+				skip_value();
+				return false;
+			}
+			std::visit([&a_number](auto const a_value){ a_number = static_cast<TValue>(a_value); }, get_number());
+			return true;
+		}
+
+		/// @brief TODO
+		bool visit(bool& a_boolean)
+		{
+			if (get_event() != json_event::boolean)
+			{
+				skip_value();
+				return false;
+			}
+			a_boolean = get_boolean();
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TChar, typename TCharTraits, typename TAllocator>
+		bool visit(std::basic_string<TChar, TCharTraits, TAllocator>& a_string)
+		{
+			if (get_event() != json_event::string)
+			{
+				skip_value();
+				return false;
+			}
+			a_string.assign(get_string());
+			return true;
+		}
+
+		/// @brief Provides the size of the array being visited, before its first element is.
+		bool visit(size_tag& a_sizeTag)
+		{
+			if (m_frame.event != json_event::start_array || get_event() != json_event::start_array)
+			{
+				return false;
+			}
+			a_sizeTag.size = m_isReplaying ? count_recorded_elements() : m_parser->count_array_elements();
+			return true;
+		}
+
+		/// @brief Visits the next element of the array being visited.
+		template <typename TValue>
+		bool visit(index_value_pair<TValue> a_indexValuePair)
+		{
+			if (!is_in_frame(json_event::start_array) || next() == json_event::end_array)
+			{
+				return false;
+			}
+			return visit(a_indexValuePair.value);
+		}
+
+		/// @brief Visits a member of the object being visited, recording the members read past until it is found.
+		template <typename TValue>
+		bool visit(name_value_pair<TValue> a_nameValuePair)
+		{
+			if (m_frame.event != json_event::start_object)
+			{
+				return false;
+			}
+
+			// Members of the object may have been recorded even though its end was read
+			auto const recordIndex = find_recorded_member(a_nameValuePair.name);
+			if (recordIndex != m_records.size())
+			{
+				return visit_recorded(recordIndex + 1, a_nameValuePair.value);
+			}
+			if (m_isReplaying || !is_in_frame(json_event::start_object))
+			{
+				return false;
+			}
+
+			while (m_parser->next() == json_event::key)
+			{
+				if (m_parser->get_string() == a_nameValuePair.name)
+				{
+					m_parser->next();
+					return visit(a_nameValuePair.value);
+				}
+				record_member();
+			}
+			return false;
+		}
+
+		/// @brief TODO
+		template <typename TContainer, typename TFactory>
+		bool visit(container<TContainer, TFactory> const& a_container)
+		{
+			return visit_composite([this, &a_container]() { return accept(*this, a_container); });
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		applicator<false, self, TApplicatorAllocator> const& m_applicator;
+		TContext m_context;
+		TEventParser* m_parser = nullptr;
+		frame m_frame;
+		/// @brief Members read past in the objects being visited, in order of these objects.
+		std::vector<record, record_allocator> m_records;
+		std::basic_string<char, std::char_traits<char>, string_allocator> m_strings;
+		/// @brief Whether events are read from m_records rather than from the parser, and which one is current.
+		bool m_isReplaying = false;
+		std::size_t m_replayIndex = 0;
+#pragma endregion
+
+#pragma region PRIVATE_ACCESSORS
+		[[nodiscard]] json_event get_event() const
+		{
+			return m_isReplaying ? m_records[m_replayIndex].event : m_parser->get_event();
+		}
+
+		[[nodiscard]] std::size_t get_depth() const
+		{
+			return m_isReplaying ? m_records[m_replayIndex].depth : m_parser->get_depth();
+		}
+
+		[[nodiscard]] std::string_view get_string() const
+		{
+			if (m_isReplaying)
+			{
+				auto const& current = m_records[m_replayIndex];
+				return std::string_view{ m_strings }.substr(current.stringFirst, current.stringSize);
+			}
+			return m_parser->get_string();
+		}
+
+		[[nodiscard]] number_value_type const& get_number() const
+		{
+			return m_isReplaying ? m_records[m_replayIndex].number : m_parser->get_number();
+		}
+
+		[[nodiscard]] bool get_boolean() const
+		{
+			return m_isReplaying ? m_records[m_replayIndex].boolean : m_parser->get_boolean();
+		}
+
+		/// @brief Whether the value being visited is an object or array whose end was not read yet.
+		[[nodiscard]] bool is_in_frame(json_event const a_startEvent) const
+		{
+			return m_frame.event == a_startEvent && get_depth() == m_frame.depth;
+		}
+
+		/// @brief Provides the index of the key record of a member of the object being visited, or the number of
+		/// records if it was not recorded. Replayed objects are recorded whole, others from their frame's start.
+		[[nodiscard]] std::size_t find_recorded_member(std::string_view const a_name) const
+		{
+			auto const first = m_isReplaying ? m_frame.replayFirst + 1 : m_frame.recordCount;
+			for (auto index = first; index < m_records.size() && m_records[index].depth >= m_frame.depth; ++index)
+			{
+				auto const& current = m_records[index];
+				if (current.event == json_event::key
+					&& current.depth == m_frame.depth
+					&& std::string_view{ m_strings }.substr(current.stringFirst, current.stringSize) == a_name)
+				{
+					return index;
+				}
+			}
+			return m_records.size();
+		}
+
+		/// @brief Counts the elements of the replayed array whose start_array record is the current one.
+		[[nodiscard]] std::size_t count_recorded_elements() const
+		{
+			auto const depth = m_records[m_replayIndex].depth;
+			std::size_t count = 0;
+			for (auto index = m_replayIndex + 1; index < m_records.size(); ++index)
+			{
+				auto const& current = m_records[index];
+				if (current.depth < depth)
+				{
+					break;
+				}
+				// Elements start with a scalar at the array depth, or with an object or array entered one level deeper
+				auto const isStart = current.event == json_event::start_object
+					|| current.event == json_event::start_array;
+				count += current.depth == (isStart ? depth + 1 : depth) && current.event != json_event::end_object
+					&& current.event != json_event::end_array ? 1 : 0;
+			}
+			return count;
+		}
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		json_event next()
+		{
+			if (!m_isReplaying)
+			{
+				return m_parser->next();
+			}
+			if (m_replayIndex + 1 == m_records.size())
+			{
+				return json_event::error;
+			}
+			return m_records[++m_replayIndex].event;
+		}
+
+		/// @brief Skips the rest of the value being visited, so its last event is the last one read.
+		void skip_value()
+		{
+			if (!m_isReplaying)
+			{
+				m_parser->skip();
+				return;
+			}
+			if (get_event() == json_event::start_object || get_event() == json_event::start_array)
+			{
+				auto const depth = get_depth();
+				while (get_depth() >= depth && next() != json_event::error) {}
+			}
+		}
+
+		/// @brief Records the event the parser just read.
+		void record_event()
+		{
+			record current{ m_parser->get_event(), m_parser->get_depth() };
+			switch (current.event)
+			{
+			case json_event::key:
+			case json_event::string:
+			{
+				auto const string = m_parser->get_string();
+				current.stringFirst = m_strings.size();
+				current.stringSize = string.size();
+				m_strings.append(string);
+				break;
+			}
+			case json_event::number:
+				current.number = m_parser->get_number();
+				break;
+			case json_event::boolean:
+				current.boolean = m_parser->get_boolean();
+				break;
+			default:
+				break;
+			}
+			m_records.push_back(current);
+		}
+
+		/// @brief Records the member whose key the parser just read, up to the last event of its value.
+		void record_member()
+		{
+			record_event();
+			if (m_parser->next() == json_event::error)
+			{
+				return;
+			}
+			record_event();
+			if (m_parser->get_event() == json_event::start_object || m_parser->get_event() == json_event::start_array)
+			{
+				auto const depth = m_parser->get_depth();
+				while (m_parser->get_depth() >= depth && m_parser->next() != json_event::error)
+				{
+					record_event();
+				}
+			}
+		}
+
+		/// @brief Visits the recorded value starting at a_recordIndex, then goes back to the current event.
+		template <typename TValue>
+		bool visit_recorded(std::size_t const a_recordIndex, TValue& a_value)
+		{
+			auto const wasReplaying = m_isReplaying;
+			auto const replayIndex = m_replayIndex;
+			m_isReplaying = true;
+			m_replayIndex = a_recordIndex;
+			auto const result = visit(a_value);
+			m_isReplaying = wasReplaying;
+			m_replayIndex = replayIndex;
+			return result;
+		}
+
+		/// @brief Visits the value starting at the current event with a_accept, then skips what it did not read of it
+		/// and drops the members it recorded.
+		template <typename TAccept>
+		bool visit_composite(TAccept&& a_accept)
+		{
+			auto const parentFrame = m_frame;
+			m_frame = { get_event(), get_depth(), m_replayIndex, m_records.size(), m_strings.size() };
+			auto const result = a_accept();
+			while (get_depth() >= m_frame.depth
+				&& (m_frame.event == json_event::start_object || m_frame.event == json_event::start_array)
+				&& next() != json_event::error) {}
+			m_records.resize(m_frame.recordCount);
+			m_strings.resize(m_frame.stringSize);
+			m_frame = parentFrame;
+			return result;
+		}
+#pragma endregion
+	};
+}
@@ -0,0 +1,295 @@
+#pragma once
+
+#include "applicator.h"
+#include "container.h"
+#include "index_value_pair.h"
+#include "is_visitable.h"
+#include "name_value_pair.h"
+#include "size_tag.h"
+
+#include "../hash/string_id.h"
+#include "../std/json_serializer.h"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+
+namespace vob::misvi
+{
+	/// @brief Writes values as JSON text straight to a buffer through a mistd::basic_json_serializer, without
+	/// building a mistd::json_value tree first. Values visiting members are written as objects, values visiting a
+	/// size or elements as arrays, and values visiting nothing as empty objects.
+	/// Vectors and arrays of numbers are written without visiting their elements, and string ids as their id.
+	template <
+		typename TContext,
+		typename TBuffer = std::string,
+		typename TApplicatorAllocator = std::allocator<char>>
+	class json_writer
+	{
+#pragma region PRIVATE_TYPES
+		using self = json_writer<TContext, TBuffer, TApplicatorAllocator>;
+		using serializer = mistd::basic_json_serializer<mistd::json_buffer_sink<TBuffer>>;
+
+		/// @brief What the value being visited was written as so far.
+		enum class frame
+		{
+			none,
+			scalar,
+			object,
+			array
+		};
+#pragma endregion
+	public:
+#pragma region CREATORS
+		/// @brief TODO
+		json_writer(
+			applicator<true, self, TApplicatorAllocator> const& a_applicator,
+			TContext a_context,
+			mistd::json_format const a_format = mistd::json_format::compact)
+			: m_applicator{ a_applicator }
+			, m_context{ std::forward<TContext>(a_context) }
+			, m_format{ a_format }
+		{}
+#pragma endregion
+
+#pragma region ACCESSORS
+		/// @brief TODO
+		[[nodiscard]] auto const& get_applicator() const
+		{
+			return m_applicator;
+		}
+
+		/// @brief TODO
+		[[nodiscard]] auto const& get_context() const
+		{
+			return m_context;
+		}
+#pragma endregion
+
+#pragma region MANIPULATORS
+		/// @brief Appends the JSON text of a value to a buffer, such as a std::string or std::vector<char>.
+		template <typename TValue>
+		void write(TBuffer& a_buffer, TValue const& a_value)
+		{
+			assert(m_serializer == nullptr);
+			serializer jsonSerializer{ mistd::json_buffer_sink<TBuffer>{ a_buffer }, m_format };
+			m_serializer = &jsonSerializer;
+			m_frame = frame::none;
+			visit(a_value);
+			m_serializer = nullptr;
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_free<self, TValue const> && (!std::is_arithmetic_v<TValue>)
+		bool visit(TValue const& a_value)
+		{
+			return visit_composite([this, &a_value]() { return accept(*this, a_value); });
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_member<self, TValue const>
+		bool visit(TValue const& a_value)
+		{
+			return visit_composite([this, &a_value]() { return a_value.accept(*this); });
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires is_visitable_static<self, TValue const>
+		bool visit(TValue const& a_value)
+		{
+			return visit_composite([this, &a_value]() { return TValue::accept(*this, a_value); });
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		requires std::is_arithmetic_v<TValue> && (!std::is_same_v<TValue, bool>)
+		bool visit(TValue const& a_number)
+		{
+			set_scalar_frame();
+			m_serializer->write_number(a_number);
+			return true;
+		}
+
+		/// @brief TODO
+		bool visit(bool const a_boolean)
+		{
+			set_scalar_frame();
+			m_serializer->write_boolean(a_boolean);
+			return true;
+		}
+
+		/// @brief TODO
+		bool visit(std::string_view const a_string)
+		{
+			set_scalar_frame();
+			m_serializer->write_string(a_string);
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TCharTraits, typename TAllocator>
+		bool visit(std::basic_string<char, TCharTraits, TAllocator> const& a_string)
+		{
+			return visit(std::string_view{ a_string.data(), a_string.size() });
+		}
+
+		/// @brief Writes the id of a string id, which reads back whatever it was constructed from.
+		template <typename TChar, typename TCharTraits>
+		bool visit(mishs::basic_string_id<TChar, TCharTraits> const& a_id)
+		{
+			return visit(a_id.get_id());
+		}
+
+		/// @brief TODO
+		template <typename TValue, typename TAllocator>
+		requires std::is_arithmetic_v<TValue> && (!std::is_same_v<TValue, bool>)
+		bool visit(std::vector<TValue, TAllocator> const& a_vector)
+		{
+			write_numbers(a_vector.data(), a_vector.size());
+			return true;
+		}
+
+		/// @brief TODO
+		template <typename TValue, std::size_t t_size>
+		requires std::is_arithmetic_v<TValue> && (!std::is_same_v<TValue, bool>)
+		bool visit(std::array<TValue, t_size> const& a_array)
+		{
+			write_numbers(a_array.data(), t_size);
+			return true;
+		}
+
+		/// @brief Starts the array being visited, whose size is implied by its elements.
+		bool visit(size_tag const&)
+		{
+			return start_frame(frame::array);
+		}
+
+		/// @brief Writes the element, which must be the next one of the array being written.
+		template <typename TValue>
+		bool visit(index_value_pair<TValue> a_indexValuePair)
+		{
+			if (!start_frame(frame::array))
+			{
+				return false;
+			}
+			return visit(std::as_const(a_indexValuePair.value));
+		}
+
+		/// @brief TODO
+		template <typename TValue>
+		bool visit(name_value_pair<TValue> a_nameValuePair)
+		{
+			if (!start_frame(frame::object))
+			{
+				return false;
+			}
+			m_serializer->write_key(a_nameValuePair.name);
+			return visit(std::as_const(a_nameValuePair.value));
+		}
+
+		/// @brief TODO
+		template <typename TContainer, typename TFactory>
+		bool visit(container<TContainer, TFactory> const& a_container)
+		{
+			return visit_composite([this, &a_container]() { return accept(*this, a_container); });
+		}
+#pragma endregion
+
+	private:
+#pragma region PRIVATE_DATA
+		applicator<true, self, TApplicatorAllocator> const& m_applicator;
+		TContext m_context;
+		mistd::json_format m_format;
+		serializer* m_serializer = nullptr;
+		frame m_frame = frame::none;
+#pragma endregion
+
+#pragma region PRIVATE_MANIPULATORS
+		/// @brief Starts the object or array being visited if nothing was written of it yet, returns false if it
+		/// was written as something else.
+		bool start_frame(frame const a_frame)
+		{
+			if (m_frame == frame::none)
+			{
+				m_frame = a_frame;
+				if (a_frame == frame::object)
+				{
+					m_serializer->start_object();
+				}
+				else
+				{
+					m_serializer->start_array();
+				}
+			}
+			return m_frame == a_frame;
+		}
+
+		/// @brief Marks the value being visited as written, if a scalar is written for it rather than for one of its
+		/// elements or members.
+		void set_scalar_frame()
+		{
+			if (m_frame == frame::none)
+			{
+				m_frame = frame::scalar;
+			}
+		}
+
+		template <typename TValue>
+		void write_numbers(TValue const* const a_numbers, std::size_t const a_count)
+		{
+			set_scalar_frame();
+			m_serializer->start_array();
+			for (auto i = std::size_t{ 0 }; i < a_count; ++i)
+			{
+				m_serializer->write_number(a_numbers[i]);
+			}
+			m_serializer->end_array();
+		}
+
+		/// @brief Visits a value with a_accept, then ends the object or array it started.
+		template <typename TAccept>
+		bool visit_composite(TAccept&& a_accept)
+		{
+			auto const parentFrame = m_frame;
+			m_frame = frame::none;
+			auto const result = a_accept();
+			switch (m_frame)
+			{
+			case frame::none:
+				m_serializer->start_object();
+				m_serializer->end_object();
+				break;
+			case frame::object:
+				m_serializer->end_object();
+				break;
+			case frame::array:
+				m_serializer->end_array();
+				break;
+			default:
+				break;
+			}
+			// A value visited directly by its parent's accept is the parent's value
+			m_frame = parentFrame == frame::none ? frame::scalar : parentFrame;
+			return result;
+		}
+#pragma endregion
+	};
+
+	namespace pmr
+	{
+		/// @brief TODO
+		template <
+			typename TContext,
+			typename TBuffer = std::pmr::string,
+			typename TApplicatorAllocator = std::pmr::polymorphic_allocator<char>>
+		using json_writer = json_writer<TContext, TBuffer, TApplicatorAllocator>;
+	}
+}
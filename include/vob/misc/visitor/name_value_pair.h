@@ -1,23 +1,59 @@
 #pragma once
 
+#include "../hash/fnv1a.h"
+
 #include <cstddef>
+#include <cstdint>
+#include <string>
 #include <string_view>
+#include <type_traits>
 
 
 namespace vob::misvi
 {
+	/// @brief A member name and its mishs::fnv1a hash, computed at compile time when the name is constant evaluated,
+	/// e.g. by declaring a constexpr member_name.
+	/// Like a std::string_view, a name constructed from a char array ends at its first null character.
+	struct member_name
+	{
+		template <std::size_t t_size>
+		constexpr member_name(char const (&a_name)[t_size])
+			: name{ a_name, get_length(a_name, t_size) }
+			, hash{ mishs::fnv1a(name) }
+		{}
+
+		template <typename TName>
+		requires std::is_convertible_v<TName const&, std::string_view>
+		constexpr member_name(TName const& a_name)
+			: name{ a_name }
+			, hash{ mishs::fnv1a(name) }
+		{}
+
+		std::string_view name;
+		std::uint64_t hash;
+
+	private:
+		static constexpr std::size_t get_length(char const* const a_name, std::size_t const a_size)
+		{
+			auto const end = std::char_traits<char>::find(a_name, a_size, '\0');
+			return end != nullptr ? static_cast<std::size_t>(end - a_name) : a_size;
+		}
+	};
+
 	/// @brief TODO
 	template <typename TValue>
 	struct name_value_pair
 	{
 		std::string_view name;
+		/// @brief mishs::fnv1a hash of name.
+		std::uint64_t nameHash;
 		TValue& value;
 	};
 
 	/// @brief TODO
 	template <typename TValue>
-	name_value_pair<TValue> nvp(std::string_view const a_name, TValue& a_value)
+	name_value_pair<TValue> nvp(member_name const a_name, TValue& a_value)
 	{
-		return { a_name, a_value };
+		return { a_name.name, a_name.hash, a_value };
 	}
 }